@@ -16,7 +16,7 @@
 #include "libdis.h"
 
 extern ia32_table_desc_t ia32_tables[];
-extern ia32_settings_t ia32_settings;
+extern thread_local ia32_settings_t ia32_settings;
 
 #define IS_SP( op )  (op->type == op_register && 	\
     (op->data.reg.id == REG_ESP_INDEX || 	\
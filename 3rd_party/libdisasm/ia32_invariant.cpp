@@ -6,7 +6,7 @@
 #include "ia32_settings.h"
 
 extern ia32_table_desc_t *ia32_tables;
-extern ia32_settings_t ia32_settings;
+extern thread_local ia32_settings_t ia32_settings;
 
 extern size_t ia32_table_lookup( unsigned char *buf, size_t buf_len,
 		unsigned int table, ia32_insn_t **raw_insn,
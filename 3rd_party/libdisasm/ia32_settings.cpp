@@ -3,7 +3,7 @@
 #include "ia32_reg.h"
 #include "ia32_insn.h"
 
-ia32_settings_t ia32_settings = {
+thread_local ia32_settings_t ia32_settings = {
 	1, 0xF4, 
 	MAX_INSTRUCTION_SIZE,
 	4, 4, 8, 4, 8,
@@ -6,7 +6,7 @@
 #include "ia32_insn.h"
 #include "ia32_reg.h"		/* for ia32_reg wrapper */
 #include "ia32_settings.h"
-extern ia32_settings_t ia32_settings;
+extern thread_local ia32_settings_t ia32_settings;
 
 #ifdef _MSC_VER
         #define snprintf        _snprintf
@@ -0,0 +1,389 @@
+/*
+ * File:    SigFile.cpp
+ * Purpose: Loading and writing of the signature and prototype files.
+ */
+#include "SigFile.h"
+
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(SigFileHeader) == 40, "SigFileHeader layout changed");
+static_assert(sizeof(SigFileEntry) == SIGFILE_SYMLEN + SIGFILE_PATLEN, "SigFileEntry is padded");
+static_assert(sizeof(ProtoFileHeader) == 28, "ProtoFileHeader layout changed");
+static_assert(sizeof(ProtoFileFunc) == 24, "ProtoFileFunc layout changed");
+
+#define SETSIZE 256                 /* Patterns are made of any byte value */
+
+/* Rounds a file offset up to the alignment of the tables */
+static uint32_t align8(size_t off)
+{
+    return uint32_t((off + 7) & ~size_t(7));
+}
+
+/* True if count elements of elemSize bytes at offset off lie in a file of
+   size bytes */
+static bool inFile(size_t size, uint32_t off, size_t count, size_t elemSize)
+{
+    return (off % 8) == 0 and off <= size and count <= (size - off) / elemSize;
+}
+
+/* Version 1 tables are used in place, as native integers: they can only be
+ * read, or written, where those are little endian */
+static bool littleEndianHost()
+{
+    const uint16_t one = 1;
+    return *(const uint8_t *)&one == 1;
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (m_mapped)
+        munmap((void *)m_data, m_size);
+#endif
+}
+
+bool MappedFile::open(const char *path)
+{
+#ifndef _WIN32
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 and st.st_size > 0)
+    {
+        void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            ::close(fd);
+            m_data = (const uint8_t *)p;
+            m_size = size_t(st.st_size);
+            m_mapped = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+    /* Cannot be mapped: read it */
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr)
+        return false;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) != 0)
+        m_copy.insert(m_copy.end(), chunk, chunk + n);
+    fclose(f);
+    m_data = m_copy.data();
+    m_size = m_copy.size();
+    return true;
+}
+
+/* Reads the sections of the byte stream files written by earlier versions */
+class LegacyReader
+{
+public:
+    LegacyReader(const uint8_t *data, size_t size) : m_pos(data), m_end(data + size) {}
+    bool tag(const char *t, size_t len)
+    {
+        if (size_t(m_end - m_pos) < len or memcmp(m_pos, t, len) != 0)
+            return false;
+        m_pos += len;
+        return true;
+    }
+    bool word(uint16_t &w)
+    {
+        if (m_end - m_pos < 2)
+            return false;
+        w = uint16_t(m_pos[0] + (m_pos[1] << 8));
+        m_pos += 2;
+        return true;
+    }
+    bool bytes(void *dst, size_t len)
+    {
+        if (size_t(m_end - m_pos) < len)
+            return false;
+        memcpy(dst, m_pos, len);
+        m_pos += len;
+        return true;
+    }
+private:
+    const uint8_t * m_pos;
+    const uint8_t * m_end;
+};
+
+bool SigFile::load(const char *path)
+{
+    if (not m_file.open(path))
+    {
+        printf("Warning: cannot open signature file %s\n", path);
+        return false;
+    }
+    const size_t size = m_file.size();
+    if (size >= 4 and memcmp(m_file.data(), "dccs", 4) == 0)
+        return loadLegacy(path);
+
+    const SigFileHeader *hdr = (const SigFileHeader *)m_file.data();
+    if (size < sizeof(SigFileHeader) or memcmp(hdr->magic, "dccS", 4) != 0)
+    {
+        printf("%s is not a dcc signature file!\n", path);
+        return false;
+    }
+    if (not littleEndianHost())
+    {
+        printf("%s: version 1 signature files are little endian, cannot be read on this host\n", path);
+        return false;
+    }
+    if (hdr->version != SIGFILE_VERSION)
+    {
+        printf("%s: signature file version %d, expected %d\n", path, hdr->version, SIGFILE_VERSION);
+        return false;
+    }
+    if ((hdr->patLen != SIGFILE_PATLEN) or (hdr->symLen != SIGFILE_SYMLEN))
+    {
+        printf("Sorry! Compiled for sym and pattern lengths of %d and %d\n", SIGFILE_SYMLEN, SIGFILE_PATLEN);
+        return false;
+    }
+    const size_t tableLen = size_t(hdr->patLen) * hdr->setSize;
+    if (hdr->fileSize != size or hdr->setSize != SETSIZE or hdr->numKeys == 0 or hdr->numVert == 0 or
+            not inFile(size, hdr->offT1, tableLen, sizeof(uint16_t)) or
+            not inFile(size, hdr->offT2, tableLen, sizeof(uint16_t)) or
+            not inFile(size, hdr->offG, hdr->numVert, sizeof(uint16_t)) or
+            not inFile(size, hdr->offHt, hdr->numKeys, sizeof(SigFileEntry)))
+    {
+        printf("%s is damaged\n", path);
+        return false;
+    }
+    numKeys = hdr->numKeys;
+    numVert = hdr->numVert;
+    ht = (const SigFileEntry *)(m_file.data() + hdr->offHt);
+    hasher.useTables(numKeys, hdr->patLen, hdr->setSize, 0, numVert,
+                     (const uint16_t *)(m_file.data() + hdr->offT1),
+                     (const uint16_t *)(m_file.data() + hdr->offT2),
+                     (const uint16_t *)(m_file.data() + hdr->offG));
+    return true;
+}
+
+bool SigFile::loadLegacy(const char *path)
+{
+    LegacyReader rd(m_file.data(), m_file.size());
+    uint16_t keys, vert, patLen, symLen, w = 0;
+    rd.tag("dccs", 4);
+    if (not (rd.word(keys) and rd.word(vert) and rd.word(patLen) and rd.word(symLen)))
+    {
+        printf("%s is damaged\n", path);
+        return false;
+    }
+    if ((patLen != SIGFILE_PATLEN) or (symLen != SIGFILE_SYMLEN))
+    {
+        printf("Sorry! Compiled for sym and pattern lengths of %d and %d\n", SIGFILE_SYMLEN, SIGFILE_PATLEN);
+        return false;
+    }
+    const size_t tableLen = size_t(patLen) * SETSIZE;
+    m_legacyTables.resize(2 * tableLen + vert);
+    static const char *tags[] = {"T1", "T2", "gg"};
+    const size_t lens[] = {tableLen, tableLen, vert};
+    uint16_t *dst = m_legacyTables.data();
+    for (int t = 0; t < 3; t++)
+    {
+        if (not rd.tag(tags[t], 2))
+        {
+            printf("Expected '%s'\n", tags[t]);
+            return false;
+        }
+        if (not rd.word(w) or w != uint16_t(lens[t] * sizeof(uint16_t)))
+        {
+            printf("Problem with size of %s: file %d, calc %d\n", tags[t], w, int(lens[t] * sizeof(uint16_t)));
+            return false;
+        }
+        for (size_t i = 0; i < lens[t]; i++)
+            if (not rd.word(*dst++))
+            {
+                printf("%s is damaged\n", path);
+                return false;
+            }
+    }
+
+    /* The byte length of the hash table counts 2 bytes per entry more than
+       are written */
+    if (not rd.tag("ht", 2))
+    {
+        printf("Expected 'ht'\n");
+        return false;
+    }
+    if (not rd.word(w) or w != uint16_t(keys * (symLen + patLen + sizeof(uint16_t))))
+    {
+        printf("Problem with size of hash table: file %d, calc %d\n", w, int(keys * (symLen + patLen + sizeof(uint16_t))));
+        return false;
+    }
+    m_legacyHt.resize(keys);
+    if (not rd.bytes(m_legacyHt.data(), keys * sizeof(SigFileEntry)))
+    {
+        printf("Could not read signature\n");
+        return false;
+    }
+    numKeys = keys;
+    numVert = vert;
+    ht = m_legacyHt.data();
+    hasher.useTables(numKeys, patLen, SETSIZE, 0, numVert, m_legacyTables.data(),
+                     m_legacyTables.data() + tableLen, m_legacyTables.data() + 2 * tableLen);
+    return true;
+}
+
+bool ProtoFile::load(const char *path)
+{
+    if (not m_file.open(path))
+    {
+        printf("Warning: cannot open library prototype data file %s\n", path);
+        return false;
+    }
+    const size_t size = m_file.size();
+    if (size >= 4 and memcmp(m_file.data(), "dccp", 4) == 0)
+        return loadLegacy(path);
+
+    const ProtoFileHeader *hdr = (const ProtoFileHeader *)m_file.data();
+    if (size < sizeof(ProtoFileHeader) or memcmp(hdr->magic, "dccP", 4) != 0)
+    {
+        printf("%s is not a dcc prototype file\n", path);
+        return false;
+    }
+    if (not littleEndianHost())
+    {
+        printf("%s: version 1 prototype files are little endian, cannot be read on this host\n", path);
+        return false;
+    }
+    if (hdr->version != SIGFILE_VERSION or hdr->symLen != SIGFILE_SYMLEN)
+    {
+        printf("%s: prototype file version %d, expected %d\n", path, hdr->version, SIGFILE_VERSION);
+        return false;
+    }
+    if (hdr->fileSize != size or
+            not inFile(size, hdr->offFunc, hdr->numFunc, sizeof(ProtoFileFunc)) or
+            not inFile(size, hdr->offArg, hdr->numArg, sizeof(uint16_t)))
+    {
+        printf("%s is damaged\n", path);
+        return false;
+    }
+    numFunc = hdr->numFunc;
+    numArg = hdr->numArg;
+    func = (const ProtoFileFunc *)(m_file.data() + hdr->offFunc);
+    arg = (const uint16_t *)(m_file.data() + hdr->offArg);
+    return true;
+}
+
+bool ProtoFile::loadLegacy(const char *path)
+{
+    LegacyReader rd(m_file.data(), m_file.size());
+    uint16_t n;
+    rd.tag("dccp", 4);
+    if (not rd.tag("FN", 2))
+    {
+        printf("FN (Function Name) subsection expected in %s\n", path);
+        return false;
+    }
+    if (not rd.word(n))
+    {
+        printf("%s is damaged\n", path);
+        return false;
+    }
+    m_legacyFunc.resize(n);
+    for (ProtoFileFunc &f : m_legacyFunc)
+    {
+        uint8_t vararg;
+        memset(&f, 0, sizeof(f));
+        if (not (rd.bytes(f.name, SIGFILE_SYMLEN) and rd.word(f.typ) and rd.word(f.numArg) and
+                 rd.word(f.firstArg) and rd.bytes(&vararg, 1)))
+        {
+            printf("%s is damaged\n", path);
+            return false;
+        }
+        f.bVararg = (vararg != 0);
+    }
+
+    if (not rd.tag("PM", 2))
+    {
+        printf("PM (Parameter) subsection expected in %s\n", path);
+        return false;
+    }
+    if (not rd.word(n))
+    {
+        printf("%s is damaged\n", path);
+        return false;
+    }
+    m_legacyArg.resize(n);
+    for (uint16_t &a : m_legacyArg)
+        if (not rd.word(a))
+        {
+            printf("%s is damaged\n", path);
+            return false;
+        }
+    numFunc = uint32_t(m_legacyFunc.size());
+    numArg = uint32_t(m_legacyArg.size());
+    func = m_legacyFunc.data();
+    arg = m_legacyArg.data();
+    return true;
+}
+
+/* Copies len bytes to offset off of the file image */
+static void put(std::vector<uint8_t> &image, uint32_t off, const void *src, size_t len)
+{
+    if (len)
+        memcpy(image.data() + off, src, len);
+}
+
+bool writeSigFile(FILE *f, const PerfectHash &hash, uint32_t numKeys, uint32_t numVert,
+                  const SigFileEntry *ht)
+{
+    if (not littleEndianHost())
+        return false;
+    SigFileHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    const size_t tableLen = size_t(SIGFILE_PATLEN) * SETSIZE;
+    memcpy(hdr.magic, "dccS", 4);
+    hdr.version = SIGFILE_VERSION;
+    hdr.patLen  = SIGFILE_PATLEN;
+    hdr.symLen  = SIGFILE_SYMLEN;
+    hdr.setSize = SETSIZE;
+    hdr.numKeys = numKeys;
+    hdr.numVert = numVert;
+    hdr.offT1   = align8(sizeof(hdr));
+    hdr.offT2   = align8(hdr.offT1 + tableLen * sizeof(uint16_t));
+    hdr.offG    = align8(hdr.offT2 + tableLen * sizeof(uint16_t));
+    hdr.offHt   = align8(hdr.offG + numVert * sizeof(uint16_t));
+    hdr.fileSize = uint32_t(hdr.offHt + numKeys * sizeof(SigFileEntry));
+
+    std::vector<uint8_t> image(hdr.fileSize, 0);
+    put(image, 0, &hdr, sizeof(hdr));
+    put(image, hdr.offT1, hash.readT1(), tableLen * sizeof(uint16_t));
+    put(image, hdr.offT2, hash.readT2(), tableLen * sizeof(uint16_t));
+    put(image, hdr.offG, hash.readG(), numVert * sizeof(uint16_t));
+    put(image, hdr.offHt, ht, numKeys * sizeof(SigFileEntry));
+    return fwrite(image.data(), 1, image.size(), f) == image.size();
+}
+
+bool writeProtoFile(FILE *f, const ProtoFileFunc *func, uint32_t numFunc,
+                    const uint16_t *arg, uint32_t numArg)
+{
+    if (not littleEndianHost())
+        return false;
+    ProtoFileHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, "dccP", 4);
+    hdr.version = SIGFILE_VERSION;
+    hdr.symLen  = SIGFILE_SYMLEN;
+    hdr.numFunc = numFunc;
+    hdr.numArg  = numArg;
+    hdr.offFunc = align8(sizeof(hdr));
+    hdr.offArg  = align8(hdr.offFunc + numFunc * sizeof(ProtoFileFunc));
+    hdr.fileSize = uint32_t(hdr.offArg + numArg * sizeof(uint16_t));
+
+    std::vector<uint8_t> image(hdr.fileSize, 0);
+    put(image, 0, &hdr, sizeof(hdr));
+    put(image, hdr.offFunc, func, numFunc * sizeof(ProtoFileFunc));
+    put(image, hdr.offArg, arg, numArg * sizeof(uint16_t));
+    return fwrite(image.data(), 1, image.size(), f) == image.size();
+}
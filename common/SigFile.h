@@ -0,0 +1,131 @@
+/*
+ * File:    SigFile.h
+ * Purpose: On-disk layout of the library signature (.sig) and prototype
+ *          (dcclibs.dat) files, and the code to load and write them.
+ *
+ * Version 1 files start with a header giving the offset of each table.
+ * Tables are stored little endian at 8 byte aligned offsets, so a loader
+ * maps the file and uses them where they are, and every process reading
+ * the same file shares its pages.  The older byte stream files ("dccs" and
+ * "dccp") are still loaded, by reading them into memory.  A big endian host
+ * refuses to load or write version 1 files.
+ */
+#pragma once
+#include "perfhlib.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#define SIGFILE_VERSION 1
+#define SIGFILE_SYMLEN  16          /* Length of symbols, including the null */
+#define SIGFILE_PATLEN  23          /* Length of patterns */
+
+struct SigFileHeader
+{
+    char        magic[4];           /* "dccS" */
+    uint16_t    version;            /* SIGFILE_VERSION */
+    uint16_t    patLen;             /* SIGFILE_PATLEN */
+    uint16_t    symLen;             /* SIGFILE_SYMLEN */
+    uint16_t    setSize;            /* Size of the character set of patterns */
+    uint32_t    numKeys;            /* Number of hash table entries */
+    uint32_t    numVert;            /* Vertices in the graph, size of g[] */
+    uint32_t    offT1;              /* uint16_t T1[patLen * setSize] */
+    uint32_t    offT2;              /* uint16_t T2[patLen * setSize] */
+    uint32_t    offG;               /* uint16_t g[numVert] */
+    uint32_t    offHt;              /* SigFileEntry ht[numKeys] */
+    uint32_t    fileSize;
+};
+
+/* One hash table entry: the pattern that hashes to its index, and the name
+ * of the library function it belongs to */
+struct SigFileEntry
+{
+    char        sym[SIGFILE_SYMLEN];
+    uint8_t     pat[SIGFILE_PATLEN];
+};
+
+struct ProtoFileHeader
+{
+    char        magic[4];           /* "dccP" */
+    uint16_t    version;            /* SIGFILE_VERSION */
+    uint16_t    symLen;             /* SIGFILE_SYMLEN */
+    uint32_t    numFunc;
+    uint32_t    numArg;
+    uint32_t    offFunc;            /* ProtoFileFunc func[numFunc], sorted by name */
+    uint32_t    offArg;             /* uint16_t arg[numArg], the hlType of each parameter */
+    uint32_t    fileSize;
+};
+
+struct ProtoFileFunc
+{
+    char        name[SIGFILE_SYMLEN];
+    uint16_t    typ;                /* hlType of the return value */
+    uint16_t    numArg;             /* Number of parameters */
+    uint16_t    firstArg;           /* Index in arg[] of the first parameter */
+    uint8_t     bVararg;            /* True if variable number of arguments */
+    uint8_t     pad;
+};
+
+/* A whole file, mapped read only, or read into memory where it cannot be */
+class MappedFile
+{
+public:
+                    MappedFile() = default;
+                    MappedFile(const MappedFile &) = delete;
+    MappedFile &    operator=(const MappedFile &) = delete;
+                    ~MappedFile();
+    bool            open(const char *path);
+    const uint8_t * data() const { return m_data; }
+    size_t          size() const { return m_size; }
+private:
+    const uint8_t * m_data = nullptr;
+    size_t          m_size = 0;
+    bool            m_mapped = false;
+    std::vector<uint8_t> m_copy;
+};
+
+/* A signature file, ready for hashing patterns */
+class SigFile
+{
+public:
+    /* Prints why and returns false if the file cannot be used */
+    bool                load(const char *path);
+    bool                mapped() const { return m_legacyTables.empty(); }
+
+    uint32_t            numKeys = 0;
+    uint32_t            numVert = 0;
+    const SigFileEntry *ht = nullptr;   /* The hash table */
+    PerfectHash         hasher;         /* Hashes a pattern to its index in ht */
+private:
+    bool                loadLegacy(const char *path);
+    MappedFile          m_file;
+    std::vector<uint16_t> m_legacyTables; /* T1, T2 and g of a "dccs" file */
+    std::vector<SigFileEntry> m_legacyHt;
+};
+
+/* The prototypes of the library functions */
+class ProtoFile
+{
+public:
+    /* Prints why and returns false if the file cannot be used */
+    bool                load(const char *path);
+
+    uint32_t            numFunc = 0;
+    uint32_t            numArg = 0;
+    const ProtoFileFunc *func = nullptr;
+    const uint16_t *    arg = nullptr;
+private:
+    bool                loadLegacy(const char *path);
+    MappedFile          m_file;
+    std::vector<ProtoFileFunc> m_legacyFunc; /* Tables of a "dccp" file */
+    std::vector<uint16_t> m_legacyArg;
+};
+
+/* Write version 1 files.  Return false if writing failed, or the host is
+ * big endian */
+bool writeSigFile(FILE *f, const PerfectHash &hash, uint32_t numKeys, uint32_t numVert,
+                  const SigFileEntry *ht);
+bool writeProtoFile(FILE *f, const ProtoFileFunc *func, uint32_t numFunc,
+                    const uint16_t *arg, uint32_t numArg);
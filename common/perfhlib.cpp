@@ -97,6 +97,22 @@ BadAlloc:
     exit(1);
 }
 
+void PerfectHash::useTables(int _NumEntry, int _EntryLen, int _SetSize, char _SetMin,
+                            int _NumVert, const uint16_t *t1, const uint16_t *t2,
+                            const uint16_t *_g)
+{
+    NumEntry = _NumEntry;
+    EntryLen = _EntryLen;
+    SetSize  = _SetSize;
+    SetMin   = _SetMin;
+    NumVert  = _NumVert;
+
+    /* hash() only reads the tables */
+    T1base = const_cast<uint16_t *>(t1);
+    T2base = const_cast<uint16_t *>(t2);
+    g      = (short *)const_cast<uint16_t *>(_g);
+}
+
 void PerfectHash::hashCleanup(void)
 {
     /* Free the storage for variable sized tables etc */
@@ -365,10 +381,11 @@ void PerfectHash::assign(void)
     }
 }
 
-int PerfectHash::hash(uint8_t *string)
+int PerfectHash::hash(const uint8_t *string) const
 {
     uint16_t u, v;
     int  j;
+    const uint16_t *T1, *T2;    /* Locals, so that tables can be shared between threads */
 
     u = 0;
     for (j=0; j < EntryLen; j++)
@@ -389,6 +406,37 @@ int PerfectHash::hash(uint8_t *string)
     return (g[u] + g[v]) % NumEntry;
 }
 
+/* Hashes HASH_LANES strings at a time.  The table lookups of the different
+    strings do not depend on each other, so they overlap in the pipeline
+    instead of waiting on one chain of additions */
+#define HASH_LANES 4
+void PerfectHash::hashBatch(const uint8_t *const strings[], int count, int result[]) const
+{
+    int i, j, k;
+
+    for (i=0; i + HASH_LANES <= count; i += HASH_LANES)
+    {
+        uint16_t u[HASH_LANES] = {0}, v[HASH_LANES] = {0};
+        const uint8_t *s[HASH_LANES];
+        for (k=0; k < HASH_LANES; k++)
+            s[k] = strings[i+k];
+        for (j=0; j < EntryLen; j++)
+        {
+            const uint16_t *T1 = T1base + j * SetSize - SetMin;
+            const uint16_t *T2 = T2base + j * SetSize - SetMin;
+            for (k=0; k < HASH_LANES; k++)
+            {
+                u[k] += T1[s[k][j]];
+                v[k] += T2[s[k][j]];
+            }
+        }
+        for (k=0; k < HASH_LANES; k++)
+            result[i+k] = (g[u[k] % NumVert] + g[v[k] % NumVert]) % NumEntry;
+    }
+    for (; i < count; i++)
+        result[i] = hash(strings[i]);
+}
+
 #if 0
 void dispRecord(int i);
 
@@ -15,12 +15,18 @@ struct PerfectHash {
     int     NumVert;    /* c times NumEntry */
     /** Set the parameters for the hash table */
     void setHashParams(int _numEntry, int _entryLen, int _setSize, char _setMin, int _numVert);
+    /** Hash with tables someone else owns, such as those of a mapped signature
+        file. map(), assign() and hashCleanup() must not be called after this */
+    void useTables(int _numEntry, int _entryLen, int _setSize, char _setMin, int _numVert,
+                   const uint16_t *t1, const uint16_t *t2, const uint16_t *_g);
 
 public:
     void map(PatternCollector * collector); /* Part 1 of creating the tables */
     void hashCleanup(); /* Frees memory allocated by setHashParams() */
     void assign(); /* Part 2 of creating the tables */
-    int hash(uint8_t *string); /* Hash the string to an int 0 .. NUMENTRY-1 */
+    int hash(const uint8_t *string) const; /* Hash the string to an int 0 .. NUMENTRY-1 */
+    /** Hash count strings, result[i] = hash(strings[i]) */
+    void hashBatch(const uint8_t *const strings[], int count, int result[]) const;
     const uint16_t *readT1(void) const { return T1base; }
     const uint16_t *readT2(void) const { return T2base; }
     const uint16_t *readG(void) const  { return (uint16_t *)g; }
@@ -14,6 +14,7 @@ class CIcodeRec;
 struct BB;
 struct LOCAL_ID;
 struct interval;
+class GraphArena;
 //TODO: consider default address value -> INVALID
 struct TYPEADR_TYPE
 {
@@ -28,6 +29,7 @@ struct TYPEADR_TYPE
 struct BB
 {
     friend struct Function;
+    friend class GraphArena;
 private:
     BB(const BB&);
     BB() : nodeType(0),traversed(DFS_NONE),
@@ -100,6 +102,7 @@ public:
     static BB * Create(void *ctx=0,const std::string &s="",Function *parent=0,BB *insertBefore=0);
     static BB * CreateIntervalBB(Function *parent);
     static BB *     Create(const rCODE &r, eBBKind _nodeType, Function *parent);
+    static BB *     Create(const rCODE &r, eBBKind _nodeType, Function *parent, GraphArena *arena);
     void    writeCode(int indLevel, Function *pProc, int *numLoc, int latchNode, int ifFollow);
     void    mergeFallThrough(CIcodeRec &Icode);
     void    dfsNumbering(std::vector<BB *> &dfsLast, int *first, int *last);
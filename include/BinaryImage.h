@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 #include <vector>
 struct PROG /* Loaded program image parameters  */
@@ -10,16 +11,30 @@ struct PROG /* Loaded program image parameters  */
     bool        fCOM=false;       /* Flag set if COM program (else EXE)*/
     int         cReloc=0;     /* No. of relocation table entries  */
     std::vector<uint32_t> relocTable; /* Ptr. to relocation table         */
+    std::vector<uint64_t> relocBits;  /* Bit per image offset, set if relocated */
     uint8_t *   map=nullptr;        /* Memory bitmap ptr                */
     int         cProcs=0;     /* Number of procedures so far      */
     int         offMain=0;    /* The offset  of the main() proc   */
     uint16_t    segMain=0;    /* The segment of the main() proc   */
     bool        bSigs=false;      /* True if signatures loaded        */
     int         cbImage=0;    /* Length of image in bytes         */
-    uint8_t *   Imagez=nullptr;      /* Allocated by loader to hold entire program image */
+    uint8_t *   Imagez=nullptr;      /* Allocated or mapped by loader to hold entire program image */
+    void *      imageMapping=nullptr; /* Start of the file mapping Imagez points into, if any */
+    size_t      imageMappingSize=0;
     int         addressingMode=0;
 public:
+                PROG() = default;
+                PROG(const PROG &) = delete;
+    PROG &      operator=(const PROG &) = delete;
+                ~PROG();
     const uint8_t *image() const {return Imagez;}
+    /* True if the word at image offset off is in the relocation table */
+    bool        isRelocated(uint32_t off) const
+                {
+                    return off/64 < relocBits.size() and ((relocBits[off/64] >> (off%64)) & 1);
+                }
+    void        indexRelocations();
+    void releaseImage();
     void displayLoadInfo();
 };
 
@@ -0,0 +1,33 @@
+/****************************************************************************
+ *          dcc project bulk memory
+ * Hands out memory from chunks that grow from 4 KB to 64 KB, each block
+ * aligned for any type.  Blocks are never given back one by one; the
+ * arenas built on it hand everything back at once.
+ ****************************************************************************/
+#pragma once
+#include <stddef.h>
+#include <memory>
+#include <vector>
+
+class BumpAllocator
+{
+public:
+                    BumpAllocator() = default;
+                    /* Memory stays with the allocator that handed it out, a copy starts empty */
+                    BumpAllocator(const BumpAllocator &) : BumpAllocator() {}
+    BumpAllocator & operator=(const BumpAllocator &) = delete;
+
+    void *          allocate(size_t size);
+    /* Gives every chunk back */
+    void            reset();
+
+    size_t          allocations() const { return m_count; }
+    size_t          bytes() const { return m_bytes; }
+private:
+    std::vector<std::unique_ptr<char[]> > m_chunks;
+    char *          m_next = nullptr;   /* Free space of the last chunk */
+    char *          m_end = nullptr;
+    size_t          m_chunkSize = 4096; /* Size of the next chunk */
+    size_t          m_count = 0;
+    size_t          m_bytes = 0;
+};
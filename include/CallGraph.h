@@ -1,19 +1,40 @@
 #pragma once
 #include "Procedure.h"
-/* CALL GRAPH NODE */
+
+#include <stdint.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+/* CALL GRAPH
+ * One node per procedure, holding the procedures it calls in the order the
+ * calls were first parsed.  The graph is displayed and generated as the tree
+ * it was built as: a procedure's callees are expanded under the call that
+ * discovered it, every other call to it is a leaf. */
 struct CALL_GRAPH
 {
-        ilFunction proc;               /* Pointer to procedure in pProcList	*/
-        std::vector<CALL_GRAPH *> outEdges; /* array of out edges                   */
-public:
-        void write();
-        CALL_GRAPH()
+        struct Node
         {
-        }
+            ilFunction          proc;           /* Pointer to procedure in pProcList	*/
+            std::vector<int>    outEdges;       /* Nodes of the callees, in call order */
+            int                 creator;        /* Node whose call discovered proc, -1 for the root */
+        };
+        std::vector<Node>   nodes;              /* nodes[0] is the first procedure parsed */
 public:
-        void writeNodeCallGraph(int indIdx);
+        explicit CALL_GRAPH(ilFunction root);
+        ilFunction  root() const { return nodes[0].proc; }
+        void write();
         bool insertCallGraph(ilFunction caller, ilFunction callee);
         bool insertCallGraph(Function *caller, ilFunction callee);
-        void insertArc(ilFunction newProc);
+        /* True if the call from node caller to node callee is where callee
+         * is expanded in the tree */
+        bool expands(int caller, int callee) const { return nodes[callee].creator == caller; }
+        /* The strongly connected components of the graph, callees before
+         * their callers.  Procedures of one component call each other. */
+        std::vector<std::vector<Function *> > bottomUpSCCs() const;
+private:
+        void writeNodeCallGraph(int node, int indIdx, bool expand);
+        int  addNode(ilFunction proc, int creator);
+        std::unordered_map<const Function *,int> m_nodeOf;     /* Procedure -> its node */
+        std::unordered_set<uint64_t> m_arcs;                    /* caller << 32 | callee */
 };
 //extern CALL_GRAPH * callGraph;	/* Pointer to the head of the call graph     */
@@ -0,0 +1,160 @@
+/*
+ * File:    ChunkedVector.h
+ * Purpose: Append-only sequence with stable element addresses and O(1)
+ *          indexing, used to hold a procedure's icodes.
+ */
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+template<class T> class ChunkedVector;
+
+/* Random access iterator kept as (container, index) rather than as a pointer,
+ * so it stays valid while the container grows, and two iterators can be
+ * compared and subtracted in O(1). */
+template<class T, bool IsConst>
+class ChunkedIterator
+{
+    typedef typename std::conditional<IsConst,const ChunkedVector<T>,ChunkedVector<T> >::type Container;
+    Container * m_owner;
+    size_t      m_idx;
+    friend class ChunkedIterator<T,not IsConst>;
+public:
+    typedef std::random_access_iterator_tag                             iterator_category;
+    typedef T                                                           value_type;
+    typedef ptrdiff_t                                                   difference_type;
+    typedef typename std::conditional<IsConst,const T *,T *>::type      pointer;
+    typedef typename std::conditional<IsConst,const T &,T &>::type      reference;
+
+    ChunkedIterator() : m_owner(nullptr), m_idx(0) {}
+    ChunkedIterator(Container *owner, size_t idx) : m_owner(owner), m_idx(idx) {}
+    template<bool C, class = typename std::enable_if<IsConst and not C>::type>
+    ChunkedIterator(const ChunkedIterator<T,C> &other) : m_owner(other.m_owner), m_idx(other.m_idx) {}
+
+    size_t      index() const { return m_idx; }
+    reference   operator*() const { return (*m_owner)[m_idx]; }
+    pointer     operator->() const { return &(*m_owner)[m_idx]; }
+    reference   operator[](difference_type d) const { return (*m_owner)[m_idx+d]; }
+
+    ChunkedIterator &operator++() { ++m_idx; return *this; }
+    ChunkedIterator &operator--() { --m_idx; return *this; }
+    ChunkedIterator operator++(int) { ChunkedIterator res(*this); ++m_idx; return res; }
+    ChunkedIterator operator--(int) { ChunkedIterator res(*this); --m_idx; return res; }
+    ChunkedIterator &operator+=(difference_type d) { m_idx += d; return *this; }
+    ChunkedIterator &operator-=(difference_type d) { m_idx -= d; return *this; }
+    ChunkedIterator operator+(difference_type d) const { return ChunkedIterator(m_owner,m_idx+d); }
+    ChunkedIterator operator-(difference_type d) const { return ChunkedIterator(m_owner,m_idx-d); }
+    friend ChunkedIterator operator+(difference_type d, const ChunkedIterator &i) { return i+d; }
+    difference_type operator-(const ChunkedIterator &o) const { return difference_type(m_idx)-difference_type(o.m_idx); }
+
+    bool operator==(const ChunkedIterator &o) const { return m_idx==o.m_idx and m_owner==o.m_owner; }
+    bool operator!=(const ChunkedIterator &o) const { return not (*this==o); }
+    bool operator<(const ChunkedIterator &o) const { return m_idx<o.m_idx; }
+    bool operator>(const ChunkedIterator &o) const { return m_idx>o.m_idx; }
+    bool operator<=(const ChunkedIterator &o) const { return m_idx<=o.m_idx; }
+    bool operator>=(const ChunkedIterator &o) const { return m_idx>=o.m_idx; }
+};
+
+/* Elements live in chunks of FIRST_CHUNK, 2*FIRST_CHUNK, 4*FIRST_CHUNK...
+ * elements.  A chunk never reallocates, so references and pointers to
+ * elements stay valid, small procedures waste little memory and the chunk
+ * of element i is found from the position of the highest set bit of
+ * i+FIRST_CHUNK.  Elements are only ever appended. */
+template<class T>
+class ChunkedVector
+{
+    static const unsigned   FIRST_CHUNK_BITS = 4;
+    static const size_t     FIRST_CHUNK = size_t(1)<<FIRST_CHUNK_BITS;
+    std::vector<std::vector<T> > m_chunks;
+    size_t                  m_size;
+
+    static unsigned highestBit(size_t v)
+    {
+#ifdef _MSC_VER
+        unsigned long res;
+        _BitScanReverse64(&res,v);
+        return unsigned(res);
+#else
+        return unsigned(sizeof(unsigned long long)*8-1-__builtin_clzll(v));
+#endif
+    }
+    static size_t chunkCapacity(size_t chunk) { return FIRST_CHUNK<<chunk; }
+    void copyFrom(const ChunkedVector &other)
+    {
+        m_chunks.clear();
+        m_chunks.reserve(other.m_chunks.size());
+        for(const std::vector<T> &chunk : other.m_chunks)
+        {
+            m_chunks.emplace_back();
+            m_chunks.back().reserve(chunkCapacity(m_chunks.size()-1));
+            m_chunks.back().insert(m_chunks.back().end(),chunk.begin(),chunk.end());
+        }
+        m_size = other.m_size;
+    }
+public:
+    typedef T                               value_type;
+    typedef T &                             reference;
+    typedef const T &                       const_reference;
+    typedef size_t                          size_type;
+    typedef ptrdiff_t                       difference_type;
+    typedef ChunkedIterator<T,false>        iterator;
+    typedef ChunkedIterator<T,true>         const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    ChunkedVector() : m_size(0) {}
+    ChunkedVector(const ChunkedVector &other) : m_size(0) { copyFrom(other); }
+    ChunkedVector &operator=(const ChunkedVector &other)
+    {
+        if(this!=&other)
+            copyFrom(other);
+        return *this;
+    }
+
+    size_t      size() const { return m_size; }
+    bool        empty() const { return m_size==0; }
+    void        clear() { m_chunks.clear(); m_size=0; }
+
+    T &operator[](size_t idx)
+    {
+        assert(idx<m_size);
+        unsigned top = highestBit(idx+FIRST_CHUNK);
+        return m_chunks[top-FIRST_CHUNK_BITS][idx+FIRST_CHUNK-(size_t(1)<<top)];
+    }
+    const T &operator[](size_t idx) const
+    {
+        assert(idx<m_size);
+        unsigned top = highestBit(idx+FIRST_CHUNK);
+        return m_chunks[top-FIRST_CHUNK_BITS][idx+FIRST_CHUNK-(size_t(1)<<top)];
+    }
+    T &         front() { return (*this)[0]; }
+    const T &   front() const { return (*this)[0]; }
+    T &         back() { return (*this)[m_size-1]; }
+    const T &   back() const { return (*this)[m_size-1]; }
+
+    void push_back(const T &v)
+    {
+        if(m_chunks.empty() or m_chunks.back().size()==chunkCapacity(m_chunks.size()-1))
+        {
+            m_chunks.emplace_back();
+            m_chunks.back().reserve(chunkCapacity(m_chunks.size()-1));
+        }
+        m_chunks.back().push_back(v);
+        m_size++;
+    }
+
+    iterator                begin() { return iterator(this,0); }
+    iterator                end() { return iterator(this,m_size); }
+    const_iterator          begin() const { return const_iterator(this,0); }
+    const_iterator          end() const { return const_iterator(this,m_size); }
+    reverse_iterator        rbegin() { return reverse_iterator(end()); }
+    reverse_iterator        rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator  rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator  rend() const { return const_reverse_iterator(begin()); }
+};
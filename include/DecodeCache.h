@@ -0,0 +1,61 @@
+/****************************************************************************
+ *          dcc project decoded instruction cache
+ * scan() only depends on the loaded image, so the instructions reached again
+ * from another procedure or path (shared tails, jump tables, the
+ * decodeIndirectJMP retries) are copied from here instead of being decoded
+ * a second time.
+ ****************************************************************************/
+#pragma once
+#include "icode.h"
+#include "error.h"
+
+#include <cassert>
+#include <stdint.h>
+#include <vector>
+
+class DecodeCache
+{
+public:
+    /* Returns the earlier decoding of the instruction at offset ip, or
+     * nullptr if it was never scanned */
+    const LLInst *  find(uint32_t ip, const x86_insn_t *&insn, eErrorId &err)
+                    {
+                        if (ip >= m_index.size() or m_index[ip] == 0)
+                        {
+                            m_misses++;
+                            return nullptr;
+                        }
+                        const Entry &e(m_entries[m_index[ip]-1]);
+                        m_hits++;
+                        insn = &e.insn;
+                        err  = e.err;
+                        return &e.ll;
+                    }
+    void            insert(uint32_t ip, uint32_t imageSize, const ICODE &decoded, eErrorId err)
+                    {
+                        if (m_index.size() < imageSize)
+                            m_index.resize(imageSize, 0);
+                        assert(ip < m_index.size() and m_index[ip] == 0);
+                        m_entries.push_back(Entry{*decoded.ll(), decoded.insn, err});
+                        m_index[ip] = uint32_t(m_entries.size());
+                    }
+    void            clear()
+                    {
+                        m_index.clear();
+                        m_entries.clear();
+                        m_hits = m_misses = 0;
+                    }
+    int             hits() const { return m_hits; }
+    int             misses() const { return m_misses; }
+private:
+    struct Entry
+    {
+        LLInst      ll;
+        x86_insn_t  insn;
+        eErrorId    err;
+    };
+    std::vector<uint32_t>   m_index;        /* Image offset -> 1 + entry index, 0 if not decoded */
+    std::vector<Entry>      m_entries;
+    int                     m_hits = 0;
+    int                     m_misses = 0;
+};
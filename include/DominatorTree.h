@@ -0,0 +1,40 @@
+/****************************************************************************
+ *          dcc project dominator tree
+ * Immediate dominators of a procedure's graph, by dfsLast index, and the
+ * tree they form.  dfsLast numbers the nodes in reverse postorder, so for a
+ * reducible graph a single pass of the Cooper, Harvey and Kennedy algorithm
+ * over the forward edges gives the dominators.  Each node of the tree gets
+ * a preorder and a postorder number, so whether a node dominates another is
+ * answered in constant time.
+ ****************************************************************************/
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+struct Function;
+
+class DominatorTree
+{
+public:
+    /* Finds the dominators of f's graph, and sets the immedDom of each of its
+     * valid nodes */
+    void        build(Function &f);
+    size_t      size() const { return m_idom.size(); }
+    /* Immediate dominator of node n, NO_DOM for a root */
+    int         immedDom(int n) const { return m_idom[n]; }
+    /* Nodes immediately dominated by n, in dfsLast order */
+    const std::vector<int> &children(int n) const { return m_children[n]; }
+    /* Whether a dominates b; a node dominates itself */
+    bool        dominates(int a, int b) const
+                {
+                    return m_pre[a] <= m_pre[b] and m_post[b] <= m_post[a];
+                }
+private:
+    int         intersect(int a, int b) const;
+    void        number();
+
+    std::vector<int>                m_idom;
+    std::vector<std::vector<int> >  m_children;
+    std::vector<int>                m_pre;      /* Preorder number in the tree  */
+    std::vector<int>                m_post;     /* Postorder number in the tree */
+};
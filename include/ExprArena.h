@@ -0,0 +1,71 @@
+/****************************************************************************
+ *          dcc project expression node storage
+ * Every Expr node is carved out of the ExprArena current on its thread, one
+ * per procedure while it is analysed or generated, and lives until that
+ * arena goes with its procedure.  Nodes are never freed one by one: deleting
+ * a node only runs its destructor, and no destructor frees its children.
+ * Constants and register leaves are never changed once built, so an arena
+ * hands out one node for each distinct leaf.
+ ****************************************************************************/
+#pragma once
+#include "BumpAllocator.h"
+#include "Enums.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+
+struct Constant;
+struct RegisterNode;
+struct LOCAL_ID;
+
+class ExprArena : private BumpAllocator
+{
+public:
+                    ExprArena() = default;
+                    ExprArena(const ExprArena &) : ExprArena() {}
+    ExprArena &     operator=(const ExprArena &) = delete;
+
+    using BumpAllocator::allocate;
+    /* The node for a leaf, built on first use */
+    Constant *      constant(uint32_t kte, uint8_t size);
+    RegisterNode *  reg(int regiIdx, regType type, const LOCAL_ID *syms);
+
+    size_t          nodes() const { return allocations(); }
+    using BumpAllocator::bytes;
+    size_t          sharedLeaves() const { return m_shared; }
+
+    /* The arena of the procedure being worked on, else the project's */
+    static ExprArena &current();
+    /* Makes an arena current for the life of the scope */
+    class Scope
+    {
+    public:
+        explicit    Scope(ExprArena &arena);
+                    ~Scope();
+    private:
+        ExprArena * m_prev;
+    };
+private:
+    struct RegKey
+    {
+        const LOCAL_ID *syms;
+        int         regiIdx;
+        int         type;
+        bool        operator==(const RegKey &o) const
+                    {
+                        return syms==o.syms and regiIdx==o.regiIdx and type==o.type;
+                    }
+    };
+    struct RegKeyHash
+    {
+        size_t      operator()(const RegKey &k) const
+                    {
+                        return std::hash<const void *>()(k.syms) ^ (size_t(k.regiIdx) << 2) ^ size_t(k.type);
+                    }
+    };
+    size_t          m_shared = 0;       /* Leaf requests answered with an existing node */
+    std::unordered_map<uint64_t,Constant *> m_constants;   /* kte << 8 | size */
+    std::unordered_map<RegKey,RegisterNode *,RegKeyHash> m_registers;
+    static thread_local ExprArena *s_current;
+};
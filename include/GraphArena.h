@@ -0,0 +1,49 @@
+/****************************************************************************
+ *          dcc project graph node storage
+ * BBs, intervals and derived sequences are carved out of an arena of their
+ * procedure: one for the BBs of the graph, which last as long as the
+ * procedure, and one for what control flow analysis builds on top of it,
+ * released as soon as the analysis is done.  Objects are never freed one
+ * by one; releasing the arena destroys them all, latest first.
+ ****************************************************************************/
+#pragma once
+#include "BumpAllocator.h"
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class GraphArena : private BumpAllocator
+{
+public:
+                    GraphArena() = default;
+                    GraphArena(const GraphArena &) : GraphArena() {}
+    GraphArena &    operator=(const GraphArena &) = delete;
+                    ~GraphArena() { release(); }
+
+    template<class T, class... Args>
+    T *             create(Args&&... args)
+                    {
+                        T *res = new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+                        if (not std::is_trivially_destructible<T>::value)
+                            m_objects.push_back(Object{res, &destroy<T>});
+                        return res;
+                    }
+    /* Destroys every object and gives the memory back */
+    void            release();
+
+    size_t          objects() const { return allocations(); }
+    using BumpAllocator::bytes;
+private:
+    struct Object
+    {
+        void *      ptr;
+        void        (*destroy)(void *);
+    };
+    template<class T>
+    static void     destroy(void *p) { static_cast<T *>(p)->~T(); }
+
+    std::vector<Object> m_objects;      /* Objects with a destructor to run */
+};
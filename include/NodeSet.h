@@ -0,0 +1,82 @@
+/****************************************************************************
+ *          dcc project node sets
+ * A set of a procedure's nodes, by dfsLast index, kept as one bit per node
+ * of the graph: adding a node and testing for one take constant time,
+ * whatever the size of the set.  Nodes are visited in dfsLast order.
+ ****************************************************************************/
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+class NodeSet
+{
+    std::vector<uint64_t> m_words;
+    size_t          m_size;     /* Number of nodes in the graph */
+public:
+    class const_iterator
+    {
+        const NodeSet * m_set;
+        size_t          m_node;
+    public:
+        const_iterator(const NodeSet *set, size_t node) : m_set(set), m_node(set->next(node)) {}
+        int             operator*() const { return int(m_node); }
+        const_iterator &operator++() { m_node = m_set->next(m_node + 1); return *this; }
+        bool            operator!=(const const_iterator &o) const { return m_node != o.m_node; }
+        bool            operator==(const const_iterator &o) const { return m_node == o.m_node; }
+    };
+
+    explicit        NodeSet(size_t numNodes = 0) : m_words((numNodes + 63) / 64, 0), m_size(numNodes) {}
+    size_t          capacity() const { return m_size; }
+    /* Empties the set and makes room for numNodes nodes */
+    void            resize(size_t numNodes)
+                    {
+                        m_words.assign((numNodes + 63) / 64, 0);
+                        m_size = numNodes;
+                    }
+    void            clear() { m_words.assign(m_words.size(), 0); }
+    bool            empty() const
+                    {
+                        for (uint64_t w : m_words)
+                            if (w)
+                                return false;
+                        return true;
+                    }
+    void            insert(int n) { m_words[size_t(n) / 64] |= uint64_t(1) << (size_t(n) % 64); }
+    void            erase(int n) { m_words[size_t(n) / 64] &= ~(uint64_t(1) << (size_t(n) % 64)); }
+    /* Nodes out of the graph, such as NO_DOM, are never in the set */
+    bool            contains(int n) const
+                    {
+                        if ((n < 0) or (size_t(n) >= m_size))
+                            return false;
+                        return (m_words[size_t(n) / 64] >> (size_t(n) % 64)) & 1;
+                    }
+    const_iterator  begin() const { return const_iterator(this, 0); }
+    const_iterator  end() const { return const_iterator(this, m_size); }
+private:
+    static size_t   lowestBit(uint64_t w)
+                    {
+#ifdef _MSC_VER
+                        unsigned long res;
+                        _BitScanForward64(&res, w);
+                        return size_t(res);
+#else
+                        return size_t(__builtin_ctzll(w));
+#endif
+                    }
+    /* First node of the set from n on, m_size if none */
+    size_t          next(size_t n) const
+                    {
+                        while (n < m_size)
+                        {
+                            uint64_t w = m_words[n / 64] >> (n % 64);
+                            if (w)
+                                return n + lowestBit(w);
+                            n = (n / 64 + 1) * 64;
+                        }
+                        return m_size;
+                    }
+};
@@ -5,6 +5,10 @@
 #include "icode.h"
 #include "StackFrame.h"
 #include "CallConvention.h"
+#include "ExprArena.h"
+#include "Profiler.h"
+#include "DominatorTree.h"
+#include "GraphArena.h"
 
 #include <QtCore/QString>
 #include <bitset>
@@ -20,6 +24,8 @@ struct Disassembler;
 struct Function;
 struct CALL_GRAPH;
 struct PROG;
+struct ParseFrame;
+class ParseWorklist;
 
 struct Function;
 
@@ -114,15 +120,21 @@ public:
     int16_t      cbParam;   /* Probable no. of bytes of parameters  	 */
     STKFRAME     args;      /* Array of arguments                   	 */
     LOCAL_ID	 localId;   /* Local identifiers                         */
+    ExprArena    exprs;     /* Expression nodes built for this proc      */
+    std::vector<PhaseSample> profile; /* Phase figures, by ePhase, with --profile */
     ID           retVal;    /* Return value - identifier    		 */
 
         /* Icodes and control flow graph */
     CIcodeRec	 Icode;     /* Object with ICODE records                 */
     FunctionCfg     m_actual_cfg;
     std::vector<BB*> m_dfsLast;
+    GraphArena   cfgNodes;  /* BBs of the graph                          */
+    GraphArena   derivedNodes; /* Intervals and derived graphs, while the
+                             * control flow is analysed                  */
     std::map<int,BB*> m_ip_to_bb;
 //                           * (reverse postorder) order            	 */
     size_t        numBBs;    /* Number of BBs in the graph cfg       	 */
+    DominatorTree m_domTree; /* Dominators, by dfsLast index             */
     bool         hasCase;   /* Procedure has a case node            	 */
 
     /* For interprocedural live analysis */
@@ -163,10 +175,10 @@ public:
     void findImmedDom();
     void FollowCtrl(CALL_GRAPH *pcallGraph, STATE *pstate);
     void process_operands(ICODE &pIcode, STATE *pstate);
-    bool process_JMP(ICODE &pIcode, STATE *pstate, CALL_GRAPH *pcallGraph);
-    bool process_CALL(ICODE &pIcode, CALL_GRAPH *pcallGraph, STATE *pstate);
+    bool process_JMP(ICODE &pIcode, STATE *pstate, ParseWorklist &work);
+    bool process_CALL(ICODE &pIcode, ParseWorklist &work, STATE *pstate);
     void freeCFG();
-    void codeGen(QIODevice & fs);
+    void codeGen();
     void mergeFallThrough(BB *pBB);
     void structIfs();
     void structLoops(derSeq *derivedG);
@@ -187,7 +199,7 @@ public:
     ICODE *translate_XCHG(LLInst *ll, ICODE &_Icode);
 protected:
     void extractJumpTableRange(ICODE& pIcode, STATE *pstate, JumpTable &table);
-    bool followAllTableEntries(JumpTable &table, uint32_t cs, ICODE &pIcode, CALL_GRAPH *pcallGraph, STATE *pstate);
+    bool followAllTableEntries(JumpTable &table, uint32_t cs, ICODE &pIcode, ParseWorklist &work, STATE *pstate);
     bool removeInEdge_Flag_and_ProcessLatch(BB *pbb, BB *a, BB *b);
     bool Case_X_and_Y(BB* pbb, BB* thenBB, BB* elseBB);
     bool Case_X_or_Y(BB* pbb, BB* thenBB, BB* elseBB);
@@ -217,8 +229,10 @@ protected:
     void addOutEdgesForConditionalJump(BB*        pBB, int next_ip, LLInst *ll);
     
 private:
-    bool    decodeIndirectJMP(ICODE &pIcode, STATE *pstate, CALL_GRAPH *pcallGraph);
-    bool    decodeIndirectJMP2(ICODE &pIcode, STATE *pstate, CALL_GRAPH *pcallGraph);
+    bool    parseFrame(ParseWorklist &work, ParseFrame &frame);
+    void    resumeFrame(ParseWorklist &work, ParseFrame &frame);
+    bool    decodeIndirectJMP(ICODE &pIcode, STATE *pstate, ParseWorklist &work);
+    bool    decodeIndirectJMP2(ICODE &pIcode, STATE *pstate, ParseWorklist &work);
 };
 typedef std::list<Function> FunctionListType;
 typedef FunctionListType lFunction;
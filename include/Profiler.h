@@ -0,0 +1,96 @@
+/****************************************************************************
+ *          dcc project phase profiler
+ * With --profile every major phase of a decompilation is timed, for the
+ * whole program and for each procedure: wall and CPU time, the number and
+ * size of heap allocations, and the peak resident set size when it ended.
+ * Whole program figures cover the phase's stretch of the run, worker
+ * threads included; their CPU time and allocations are those of the threads
+ * working for the program, so inputs of a batch decompiled side by side are
+ * measured apart, while the peak RSS is the process's.  lowLevelAnalysis
+ * runs inside buildCFG, so its whole program figures are the sum over
+ * procedures.  A procedure's figures leave out the time spent in the same
+ * phase of another procedure it led to (FollowCtrl and dataFlow follow
+ * calls), so they add up to the phase.
+ * Without --profile the timers do nothing.
+ ****************************************************************************/
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <QtCore/QString>
+
+class Function;
+class Project;
+
+enum ePhase
+{
+    PH_LOAD = 0,        /* Project::load                    */
+    PH_PARSE,           /* FollowCtrl                       */
+    PH_BUILD_CFG,       /* buildCFG                         */
+    PH_LOW_LEVEL,       /* lowLevelAnalysis                 */
+    PH_DATA_FLOW,       /* dataFlow                         */
+    PH_CONTROL_FLOW,    /* controlFlowAnalysis              */
+    PH_CODE_GEN,        /* codeGen                          */
+    PH_COUNT
+};
+
+struct PhaseSample
+{
+    double      wall = 0;       /* Seconds */
+    double      cpu = 0;        /* Seconds */
+    uint64_t    allocs = 0;
+    uint64_t    allocBytes = 0;
+    long        peakRss = 0;    /* KB, whole program samples only */
+    void        add(const PhaseSample &o);
+    void        subtract(const PhaseSample &o);
+};
+
+/* CPU time and allocations of the threads that have worked for a program,
+ * added up as each one moves on to another program */
+struct ProgramUsage
+{
+    std::atomic<uint64_t> cpuNs{0};
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> allocBytes{0};
+};
+
+/* Times one phase for the life of the scope, of the whole program when proc
+ * is null, else of proc only */
+class PhaseTimer
+{
+public:
+                PhaseTimer(ePhase phase, Function *proc = nullptr);
+                ~PhaseTimer();
+                PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+    /* Ends the timing before the scope does */
+    void        stop();
+private:
+    ePhase      m_phase;
+    Function *  m_proc;
+    bool        m_on;
+    PhaseTimer *m_outer;        /* Procedure timer this one runs inside */
+    PhaseSample m_start;
+    PhaseSample m_nested;       /* Same phase, other procedures */
+};
+
+namespace Profiler
+{
+    /* Turns the timers on; call before any thread is started */
+    void        enable();
+    bool        enabled();
+    const char *phaseName(ePhase phase);
+    /* Called by the program's operator new */
+    void        countAllocation(size_t size);
+    /* Adds what this thread used since it last changed program to proj's
+     * usage; called by Project::setCurrent */
+    void        creditThread(Project *proj);
+    /* The whole program figures of proj for phase */
+    PhaseSample phaseTotal(const Project &proj, ePhase phase);
+    /* The figures of proj as a JSON object */
+    std::string toJson(const Project &proj);
+    /* Writes the JSON objects of each program to fname */
+    bool        write(const QString &fname, const std::vector<std::string> &programs);
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *          dcc project task scheduler
+ * Runs a batch of tasks on a fixed number of worker threads.  A task only
+ * becomes runnable once every task it depends on has finished, so callers
+ * can express "must keep the serial order" between conflicting tasks and
+ * let everything else run concurrently.
+ ****************************************************************************/
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+class TaskGraph
+{
+public:
+    typedef std::function<void()> Task;
+
+    int     addTask(const Task &t);             /* Returns the task's id        */
+    void    addDependency(int before, int after); /* after waits for before   */
+    void    run(unsigned jobs);                 /* Runs, then forgets all tasks */
+    size_t  size() const { return m_nodes.size(); }
+
+    static unsigned hardwareJobs();             /* Number of cores, at least 1  */
+private:
+    struct Node
+    {
+        Task                task;
+        std::vector<int>    successors;         /* Tasks waiting for this one   */
+        int                 numPreds = 0;       /* Unfinished predecessors      */
+    };
+    std::vector<Node> m_nodes;
+};
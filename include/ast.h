@@ -8,6 +8,7 @@
 
 #include "Enums.h"
 #include "msvc_fixes.h"
+#include "ChunkedVector.h"
 
 #include <boost/range/iterator_range.hpp>
 #include <stdint.h>
@@ -35,7 +36,7 @@ struct ICODE;
 struct LLInst;
 struct LLOperand;
 struct ID;
-typedef std::list<ICODE>::iterator iICODE;
+typedef ChunkedIterator<ICODE,false> iICODE;
 typedef boost::iterator_range<iICODE> rICODE;
 #include "IdentType.h"
 
@@ -55,8 +56,13 @@ public:
     {
 
     }
-    /** Recursively deallocates the abstract syntax tree rooted at *exp */
+    /** Nodes are owned by the ExprArena they were allocated from, which frees
+     * them all at once; a node does not delete its children */
     virtual ~Expr() {}
+    static void *operator new(size_t size);
+    static void *operator new(size_t, void *where) { return where; }
+    static void operator delete(void *) {}
+    static void operator delete(void *, void *) {}
 public:
     virtual QString walkCondExpr (Function * pProc, int* numLoc) const=0;
     virtual Expr *inverse() const=0; // return new COND_EXPR that is invarse of this
@@ -73,7 +79,7 @@ struct UnaryOperator : public Expr
     Expr *unaryExp;
     virtual Expr *inverse() const
     {
-        if (m_type == NEGATION) //TODO: memleak here
+        if (m_type == NEGATION)
         {
             return unaryExp->clone();
         }
@@ -93,11 +99,6 @@ struct UnaryOperator : public Expr
         newExp->unaryExp = sub_expr;
         return (newExp);
     }
-    ~UnaryOperator()
-    {
-        delete unaryExp;
-        unaryExp=nullptr;
-    }
 public:
     int hlTypeSize(Function *pproc) const;
     virtual QString walkCondExpr(Function *pProc, int *numLoc) const;
@@ -124,13 +125,6 @@ struct BinaryOperator : public Expr
         m_lhs=l;
         m_rhs=r;
     }
-    ~BinaryOperator()
-    {
-        assert(m_lhs!=m_rhs or m_lhs==nullptr);
-        delete m_lhs;
-        delete m_rhs;
-        m_lhs=m_rhs=nullptr;
-    }
     static BinaryOperator *Create(condOp o,Expr *l,Expr *r)
     {
         BinaryOperator *res = new BinaryOperator(o);
@@ -263,9 +257,11 @@ struct Constant : public AstIdent
         kte.kte = _kte;
         kte.size = size;
     }
+    /* Constants are shared: use these rather than new */
+    static Constant *Create(uint32_t _kte, uint8_t size);
     virtual Expr *clone() const
     {
-        return new Constant(*this);
+        return Create(kte.kte, kte.size);
     }
     QString walkCondExpr(Function *pProc, int *numLoc) const;
     int hlTypeSize(Function *pproc) const;
@@ -306,12 +302,14 @@ struct RegisterNode : public AstIdent
         regiType = reg_type;
         regiIdx = idx;
     }
-    RegisterNode(const LLOperand &, LOCAL_ID *locsym);
+    /* Register leaves are shared: use these rather than new */
+    static RegisterNode *Create(int idx, regType reg_type, const LOCAL_ID *syms);
+    static RegisterNode *Create(const LLOperand &op, LOCAL_ID *locsym);
 
     //RegisterNode(eReg regi, uint32_t icodeFlg, LOCAL_ID *locsym);
     virtual Expr *clone() const
     {
-        return new RegisterNode(*this);
+        return Create(regiIdx, regiType, m_syms);
     }
     QString walkCondExpr(Function *pProc, int *numLoc) const;
     int hlTypeSize(Function *) const;
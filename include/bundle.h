@@ -1,21 +1,57 @@
 /*****************************************************************************
  * Project: dcc
  * File:    bundle.h
- * Purpose: Module to handle the bundle type (array of pointers to strings).
+ * Purpose: Module to handle the bundle type (the declarations and code of
+ *          the procedure being generated).
  * (C) Cristina Cifuentes
  ****************************************************************************/
 #pragma once
 #include <stdio.h>
+#include <stdint.h>
+#include <string>
 #include <vector>
 #include <QtCore/QString>
 #include <QtCore/QIODevice>
 
-struct strTable : std::vector<QString>
+/* Output text, held as the Latin-1 bytes that are written out.  Each append
+ * is a line, numbered in order, so a label can be backpatched onto it; the
+ * label is only recorded, and written over the start of the line by write().
+ * Labels are numbered from 0 in each procedure; the numbers are left out of
+ * the text and written in when the procedure's place in the file, and so
+ * its first label, is known. */
+struct LineBuffer
 {
     /* Returns the next available index into the table */
-    size_t nextIdx() {return size();}
-public:
+    size_t nextIdx() const {return m_starts.size();}
+    void append(const char *s, size_t len);
+    void append(const QString &s);
+    /* Appends the line before, label, after */
+    void appendWithLabel(const char *before, int label, const char *after);
     void addLabelBundle(int idx, int label);
+    void write(QIODevice &ios, int labelBase) const;
+    /* Empties the buffer, keeping its storage for the next procedure */
+    void clear()
+    {
+        m_text.clear();
+        m_starts.clear();
+        m_labels.clear();
+        m_lineLabels.clear();
+    }
+private:
+    struct LabelRef
+    {
+        uint32_t    off;                /* Where the number goes in m_text */
+        int         label;
+    };
+    std::string             m_text;
+    std::vector<uint32_t>   m_starts;   /* Offset in m_text of each line */
+    struct LineLabel
+    {
+        uint32_t    line;
+        int         label;
+    };
+    std::vector<LabelRef>   m_labels;   /* In order of offset */
+    std::vector<LineLabel>  m_lineLabels; /* Backpatched, in order of addition */
 };
 
 struct bundle
@@ -27,18 +63,19 @@ public:
     void appendDecl(const QString &);
     void init()
     {
+        head.clear();
         decl.clear();
         code.clear();
+        labels = 0;
     }
-    strTable    decl;   /* Declarations */
-    strTable    code;   /* C code       */
-    int current_indent;
+    LineBuffer  head;   /* Procedure header */
+    LineBuffer  decl;   /* Declarations */
+    LineBuffer  code;   /* C code       */
+    int         labels = 0; /* Labels used so far */
 };
 
-extern bundle cCode;
-#define lineSize	360		/* 3 lines in the mean time */
-
-//void    newBundle (bundle *procCode);
-void    writeBundle (QIODevice & ios, bundle procCode);
-void    freeBundle (bundle *procCode);
+extern thread_local bundle cCode;
 
+/* Writes the header, declarations and code of procCode, numbering its labels
+ * after those already written, and empties it */
+void    writeBundle (QIODevice & ios, bundle &procCode);
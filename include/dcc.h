@@ -22,11 +22,11 @@
 #include "BasicBlock.h"
 class Project;
 /* CALL GRAPH NODE */
-extern bundle cCode;			/* Output C procedure's declaration and code */
+extern thread_local bundle cCode;	/* Output C procedure's declaration and code */
 
 /**** Global variables ****/
 
-extern QString asm1_name, asm2_name; /* Assembler output filenames 		*/
+extern thread_local QString asm1_name, asm2_name; /* Assembler output filenames */
 
 /** Command line option flags */
 struct OPTION
@@ -41,6 +41,11 @@ struct OPTION
     bool Calls;         /* Follow register indirect calls */
     QString	filename;			/* The input filename */
     uint32_t CustomEntryPoint;
+    unsigned Jobs;      /* Threads used for per-procedure analysis, or per file in batch mode */
+    bool LegacyDecode;  /* Scanner decodes the image with its own state table */
+    bool ReadImage;     /* Loaders copy the file instead of mapping it */
+    bool Batch;         /* Several inputs are decompiled, each on its own Project */
+    QString ProfileFile; /* Where --profile writes the phase figures, empty if not */
 };
 
 extern OPTION option;       /* Command line options             */
@@ -68,7 +73,7 @@ struct STATS
         int		totalHL;        /* total number of high-level Icod insts       */
 };
 
-extern STATS stats; /* Icode statistics */
+extern thread_local STATS stats; /* Icode statistics, one set per analysis thread */
 
 
 /**** Global function prototypes ****/
@@ -34,6 +34,13 @@ enum eErrorId
 };
 
 
+/* Thrown by fatalError() instead of exiting when decompiling a batch, so that
+   only the program being decompiled is given up */
+struct FatalError
+{
+    eErrorId id;
+};
+
 void fatalError(eErrorId errId, ...);
 void reportError(eErrorId errId, ...);
 
@@ -73,6 +73,7 @@ struct interval
     queue           nodes;         /* Nodes of the interval*/
     queue::iterator currNode;      /* Current node     */
     interval *      next=0;          /* Next interval    */
+    BB *            derivedBB=0;     /* Node of the interval in the next order graph */
     BB *            firstOfInt();
                     interval() : currNode(nodes.end()){
                     }
@@ -86,7 +87,6 @@ struct derSeq_Entry
     BB *                Gi=nullptr;        /* Graph pointer        */
     std::list<interval *> m_intervals;
     interval *          Ii=nullptr;        /* Interval list of Gi  */
-    ~derSeq_Entry();
 public:
     void findIntervals(Function *c);
 };
@@ -95,5 +95,4 @@ class derSeq : public std::list<derSeq_Entry>
 public:
     void display();
 };
-void    freeDerivedSeq(derSeq &derivedG);                   /* reducible.c  */
 
@@ -9,6 +9,7 @@
 #include "Enums.h"
 #include "state.h"			// State depends on INDEXBASE, but later need STATE
 #include "CallConvention.h"
+#include "ChunkedVector.h"
 
 #include <boost/range/iterator_range.hpp>
 #include <QtCore/QString>
@@ -16,6 +17,7 @@
 #include <memory>
 #include <vector>
 #include <list>
+#include <unordered_map>
 #include <bitset>
 #include <set>
 #include <algorithm>
@@ -30,32 +32,26 @@ struct STKFRAME;
 class CIcodeRec;
 struct ICODE;
 struct bundle;
-typedef std::list<ICODE>::iterator iICODE;
-typedef std::list<ICODE>::reverse_iterator riICODE;
+typedef ChunkedIterator<ICODE,false> iICODE;
+typedef std::reverse_iterator<iICODE> riICODE;
 typedef boost::iterator_range<iICODE> rCODE;
 
+/* Set of live/defined registers, one bit per eReg.  All real-mode registers,
+ * including the temporaries, fit into a single word, so set operations never
+ * allocate. */
 struct LivenessSet
 {
-    std::set<eReg> registers;
+    uint64_t registers;
 public:
-    LivenessSet(const std::initializer_list<eReg> &init) : registers(init) {}
-    LivenessSet() {}
-    LivenessSet(const LivenessSet &other) : registers(other.registers)
+    LivenessSet(const std::initializer_list<eReg> &init) : registers(0)
     {
+        for(eReg r : init)
+            registers |= regBit(r);
     }
+    LivenessSet() : registers(0) {}
     void reset()
     {
-        registers.clear();
-    }
-
-    //    LivenessSet(LivenessSet &&other) : LivenessSet()
-    //    {
-    //        swap(*this,other);
-    //    }
-    LivenessSet &operator=(LivenessSet other)
-    {
-        swap(*this,other);
-        return *this;
+        registers = 0;
     }
     friend void swap(LivenessSet& first, LivenessSet& second) // nothrow
     {
@@ -63,25 +59,17 @@ public:
     }
     LivenessSet &operator|=(const LivenessSet &other)
     {
-        registers.insert(other.registers.begin(),other.registers.end());
+        registers |= other.registers;
         return *this;
     }
     LivenessSet &operator&=(const LivenessSet &other)
     {
-        std::set<eReg> res;
-        std::set_intersection(registers.begin(),registers.end(),
-                              other.registers.begin(),other.registers.end(),
-                              std::inserter(res, res.end()));
-        registers = res;
+        registers &= other.registers;
         return *this;
     }
     LivenessSet &operator-=(const LivenessSet &other)
     {
-        std::set<eReg> res;
-        std::set_difference(registers.begin(),registers.end(),
-                            other.registers.begin(),other.registers.end(),
-                            std::inserter(res, res.end()));
-        registers = res;
+        registers &= ~other.registers;
         return *this;
     }
     LivenessSet operator-(const LivenessSet &other) const
@@ -98,7 +86,7 @@ public:
     }
     bool any() const
     {
-        return not registers.empty();
+        return registers!=0;
     }
     bool operator==(const LivenessSet &other) const
     {
@@ -110,11 +98,16 @@ public:
     LivenessSet &addReg(int r);
     bool testReg(int r) const
     {
-        return registers.find(eReg(r))!=registers.end();
+        return (registers & regBit(r))!=0;
     }
     bool testRegAndSubregs(int r) const;
     LivenessSet &clrReg(int r);
 private:
+    static uint64_t regBit(int r)
+    {
+        assert(r>=0 and r<64);
+        return uint64_t(1)<<r;
+    }
     void postProcessCompositeRegs();
 };
 
@@ -498,8 +491,8 @@ public:
         struct Use
         {
             int Reg; // used register
-            std::vector<std::list<ICODE>::iterator> uses; // use locations [MAX_USES]
-            void removeUser(std::list<ICODE>::iterator us)
+            std::vector<iICODE> uses; // use locations [MAX_USES]
+            void removeUser(iICODE us)
             {
                 // ic is no no longer an user
                 auto iter=std::find(uses.begin(),uses.end(),us);
@@ -521,7 +514,7 @@ public:
         {
             return idx[regIdx].uses.size();
         }
-        void recordUse(int regIdx,std::list<ICODE>::iterator location)
+        void recordUse(int regIdx,iICODE location)
         {
             idx[regIdx].uses.push_back(location);
         }
@@ -529,7 +522,7 @@ public:
         {
             idx[regIdx].uses.erase(idx[regIdx].uses.begin()+use_idx);
         }
-        void remove(int regIdx,std::list<ICODE>::iterator ic)
+        void remove(int regIdx,iICODE ic)
         {
             Use &u(idx[regIdx]);
             u.removeUser(ic);
@@ -608,10 +601,14 @@ public:
 //    rTargetRange m_middle_level;
 //};
 // This is the icode array object.
-class CIcodeRec : public std::list<ICODE>
+class CIcodeRec : public ChunkedVector<ICODE>
 {
+    std::unordered_map<uint32_t,iterator> m_labels; /* first icode with a given label */
 public:
     CIcodeRec();	// Constructor
+    CIcodeRec(const CIcodeRec &other);
+    CIcodeRec & operator=(const CIcodeRec &other);
+    void        clear();
 
     ICODE *     addIcode(ICODE *pIcode);
     void        SetInBB(rCODE &rang, BB* pnewBB);
@@ -7,6 +7,7 @@
 
 #pragma once
 #include "msvc_fixes.h"
+#include "ChunkedVector.h"
 #include "types.h"
 #include "Enums.h"
 #include "machine_x86.h"
@@ -16,6 +17,7 @@
 #include <vector>
 #include <list>
 #include <set>
+#include <unordered_map>
 #include <algorithm>
 
 /* Type definition */
@@ -25,7 +27,7 @@ struct Expr;
 struct AstIdent;
 struct ICODE;
 struct LLInst;
-typedef std::list<ICODE>::iterator iICODE;
+typedef ChunkedIterator<ICODE,false> iICODE;
 struct IDX_ARRAY : public std::vector<iICODE>
 {
     bool inList(iICODE idx) const
@@ -146,6 +148,11 @@ public:
     eReg                    getPairedRegister(eReg first) const;
 };
 
+/* The identifiers of a procedure.  Entries are only ever appended, as
+ * expressions refer to them by index.  Each kind of lookup has a hash index
+ * from its key to the first entry matching it, filled as entries are added;
+ * the keys are read from the entry's union exactly as the lookup compares
+ * them, so an index answers as a scan of id_arr would. */
 struct LOCAL_ID
 {
     std::vector<ID> id_arr;
@@ -153,6 +160,17 @@ protected:
     int newLongIdx(int16_t seg, int16_t offH, int16_t offL, uint8_t regi, hlType t);
     int newLongGlb(int16_t seg, int16_t offH, int16_t offL, hlType t);
     int newLongStk(hlType t, int offH, int offL);
+private:
+    void newIdent(hlType t, frameType f);
+    int indexLast();
+    std::unordered_map<uint64_t,int> m_byReg;       /* (type, regi) */
+    std::unordered_map<uint64_t,int> m_byStk;       /* (bwId.off, bwId.regOff) */
+    std::unordered_map<uint32_t,int> m_byFrameOff;  /* bwId.off of byte/word ids with no regOff */
+    std::unordered_map<uint64_t,int> m_byGlb;       /* (seg, off, regi) */
+    std::unordered_map<uint64_t,int> m_byLongReg;   /* (h, l) of long register pairs */
+    std::unordered_map<uint64_t,int> m_byLongStk;   /* (type, offH, offL) of long stack ids */
+    std::unordered_map<uint64_t,int> m_byLongGlb;   /* (seg, offH, offL) */
+    std::unordered_map<uint64_t,int> m_byLongIdx;   /* (seg, offH, offL, regi) */
 public:
     LOCAL_ID()
     {
@@ -167,8 +185,11 @@ public:
     int newLongReg(hlType t, const LONGID_TYPE &longT, iICODE ix_);
     int newLong(opLoc sd, iICODE pIcode, hlFirst f, iICODE ix, operDu du, int off);
     int newLong(opLoc sd, iICODE pIcode, hlFirst f, iICODE ix, operDu du, LLInst &atOffset);
-    void newIdent(hlType t, frameType f);
     void flagByteWordId(int off);
+    /* Index of the stack identifier at off, csym() if there is none */
+    int findByteWordStk(int off, uint8_t regOff) const;
+    /* Index of the global identifier indexed by regi, csym() if there is none */
+    int findIntIdx(int16_t seg, int16_t off, eReg regi) const;
     void propLongId(uint8_t regL, uint8_t regH, const QString & name);
     size_t csym() const {return id_arr.size();}
     void newRegArg(ICODE & picode, ICODE & ticode) const;
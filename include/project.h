@@ -6,11 +6,14 @@
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_map.hpp>
 #include <boost/icl/split_interval_map.hpp>
+#include <unordered_map>
 #include <unordered_set>
 #include <QtCore/QString>
 #include "symtab.h"
 #include "BinaryImage.h"
 #include "Procedure.h"
+#include "DecodeCache.h"
+#include "Profiler.h"
 class QString;
 class SourceMachine;
 struct CALL_GRAPH;
@@ -23,6 +26,7 @@ class IProject
 class Project : public IProject
 {
     static  Project *s_instance;
+    static  thread_local Project *s_current;
             QString     m_fname;
             QString     m_project_name;
             QString     m_output_path;
@@ -36,11 +40,23 @@ public:
             FunctionListType pProcList;
             CALL_GRAPH * callGraph;	/* Pointer to the head of the call graph     */
             PROG        prog;   		/* Loaded program image parameters  */
+            int         labelIdx = 1;   /* Index of the next label in the C output */
+            unsigned    jobs = 0;       /* Threads for its procedures, 0 for option.Jobs */
+            DecodeCache decodeCache;    /* Instructions scanned so far, by image offset */
+            ExprArena   exprs;          /* Expression nodes built outside any procedure */
+            PhaseSample profile[PH_COUNT]; /* Whole program phase figures, with --profile */
+            ProgramUsage usage;         /* Threads' figures credited so far, with --profile */
+private:
+            /* Indexes of pProcList, kept by createFunction() and clearFunctions() */
+            std::unordered_map<uint32_t,ilFunction> m_byEntry;          /* procEntry -> procedure */
+            std::unordered_map<const Function *,ilFunction> m_byAddr;  /* &procedure -> procedure */
+public:
                         // no copies
                         Project(const Project&) = delete;
     const   Project &   operator=(const Project & l) =delete;
                         // only moves
                         Project(); // default constructor,
+                        ~Project();
 
 public:
             void        create(const QString &a);
@@ -49,9 +65,11 @@ public:
     const   QString &   project_name() const {return m_project_name;}
     const   QString &   binary_path() const {return m_fname;}
             QString     output_name(const char *ext);
+            unsigned    procJobs() const;
             ilFunction  funcIter(Function *to_find);
             ilFunction  findByEntry(uint32_t entry);
-            ilFunction  createFunction(FunctionType *f, const QString & name);
+            ilFunction  createFunction(FunctionType *f, const QString & name, uint32_t entry);
+            void        clearFunctions();
             bool        valid(ilFunction iter);
 
             int         getSymIdxByAddr(uint32_t adr);
@@ -62,6 +80,7 @@ public:
     const   SYM &       getSymByIdx(size_t idx) const;
 
     static  Project *   get();
+    static  void        setCurrent(Project *p); /* get() returns p on this thread and in the tasks it runs, nullptr restores the default */
             PROG *      binary() {return &prog;}
             SourceMachine *machine();
 
@@ -9,6 +9,7 @@
 
 #include <QtCore/QString>
 #include <string>
+#include <unordered_map>
 #include <stdint.h>
 struct Expr;
 struct AstIdent;
@@ -73,13 +74,39 @@ public:
     }
 
 };
-/* SYMBOL TABLE */
+/* SYMBOL TABLE
+ * Entries are only ever appended, by updateGlobSym, so an index stays valid
+ * for the life of the table; expressions refer to globals by index.  The
+ * labels are hashed to their index, so lookups do not scan the table. */
 class SYMTAB : public SymbolTableCommon<SYM>
 {
 
 public:
     void updateSymType(uint32_t symbol, const TypeContainer &tc);
     SYM *updateGlobSym(uint32_t operand, int size, uint16_t duFlag, bool &inserted_new);
+    iterator findByLabel(uint32_t lab)
+    {
+        auto iter = m_byLabel.find(lab);
+        return iter==m_byLabel.end() ? end() : begin()+iter->second;
+    }
+    const_iterator findByLabel(uint32_t lab) const
+    {
+        auto iter = m_byLabel.find(lab);
+        return iter==m_byLabel.end() ? end() : begin()+iter->second;
+    }
+    /* Index of the symbol at address lab, size() if there is none */
+    size_t indexOf(uint32_t lab) const
+    {
+        auto iter = m_byLabel.find(lab);
+        return iter==m_byLabel.end() ? size() : iter->second;
+    }
+    void clear()
+    {
+        SymbolTableCommon<SYM>::clear();
+        m_byLabel.clear();
+    }
+private:
+    std::unordered_map<uint32_t,size_t> m_byLabel; /* label -> index */
 };
 struct Function;
 struct SYMTABLE
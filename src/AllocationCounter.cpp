@@ -0,0 +1,35 @@
+/*
+ * File:    AllocationCounter.cpp
+ * Purpose: Replacement global operator new/delete, counting the heap
+ *          allocations of the program for --profile and dcc_phasebench.
+ *          Linked into those programs only, not into dcc_lib, so that the
+ *          tools built on the library keep the standard allocator.
+ */
+
+#include "Profiler.h"
+
+#include <cstdlib>
+#include <new>
+
+void *operator new(size_t size)
+{
+    Profiler::countAllocation(size);
+    void *res = malloc(size ? size : 1);
+    if (res == nullptr)
+        throw std::bad_alloc();
+    return res;
+}
+
+/* GCC cannot see that this operator new is malloc based, and takes the free
+ * of its memory for a mismatch */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
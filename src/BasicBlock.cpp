@@ -14,9 +14,12 @@
 using namespace std;
 using namespace boost;
 
+/**
+ *  An empty BB that is not part of the graph: it goes with parent's intervals
+ */
 BB *BB::Create(void */*ctx*/, const string &/*s*/, Function *parent, BB */*insertBefore*/)
 {
-    BB *pnewBB = new BB;
+    BB *pnewBB = parent ? parent->derivedNodes.create<BB>() : new BB;
     pnewBB->Parent = parent;
     return pnewBB;
 }
@@ -25,9 +28,14 @@ BB *BB::Create(void */*ctx*/, const string &/*s*/, Function *parent, BB */*inser
  *  @arg fin - last of basic block's instructions
 */
 BB *BB::Create(const rCODE &r,eBBKind _nodeType, Function *parent)
+{
+    return Create(r, _nodeType, parent, parent ? &parent->cfgNodes : nullptr);
+}
+/* As above, the BB being carved out of arena, when there is one */
+BB *BB::Create(const rCODE &r, eBBKind _nodeType, Function *parent, GraphArena *arena)
 {
     BB* pnewBB;
-    pnewBB = new BB;
+    pnewBB = arena ? arena->create<BB>() : new BB;
     pnewBB->nodeType = _nodeType;	/* Initialise */
     pnewBB->immedDom = NO_DOM;
     pnewBB->loopHead = pnewBB->caseHead = pnewBB->caseTail =
@@ -55,7 +63,7 @@ BB *BB::Create(const rCODE &r,eBBKind _nodeType, Function *parent)
 BB *BB::CreateIntervalBB(Function *parent)
 {
     iICODE endOfParent = parent->Icode.end();
-    return Create(make_iterator_range(endOfParent,endOfParent),INTERVAL_NODE,nullptr);
+    return Create(make_iterator_range(endOfParent,endOfParent),INTERVAL_NODE,nullptr,&parent->derivedNodes);
 }
 
 static const char *const s_nodeType[] = {"branch", "if", "case", "fall", "return", "call",
@@ -421,7 +429,7 @@ ICODE &BB::back()
 
 size_t BB::size()
 {
-    return distance(instructions.begin(),instructions.end());
+    return std::distance(instructions.begin(),instructions.end());
 }
 
 ICODE &BB::front()
@@ -0,0 +1,39 @@
+/*
+ * File:    BumpAllocator.cpp
+ * Purpose: Chunked bulk allocation shared by the expression and graph arenas
+ */
+
+#include "BumpAllocator.h"
+
+#include <algorithm>
+#include <cstddef>
+
+static const size_t MAX_CHUNK = 64*1024;
+
+void *BumpAllocator::allocate(size_t size)
+{
+    size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+    if (size_t(m_end - m_next) < size)
+    {
+        size_t chunk = std::max(m_chunkSize, size);
+        m_chunks.emplace_back(new char[chunk]);
+        m_next = m_chunks.back().get();
+        m_end = m_next + chunk;
+        if (m_chunkSize < MAX_CHUNK)
+            m_chunkSize *= 2;
+    }
+    void *res = m_next;
+    m_next += size;
+    m_count++;
+    m_bytes += size;
+    return res;
+}
+
+void BumpAllocator::reset()
+{
+    m_chunks.clear();
+    m_next = m_end = nullptr;
+    m_chunkSize = 4096;
+    m_count = 0;
+    m_bytes = 0;
+}
@@ -5,15 +5,9 @@
 
 CConv *CConv::create(Type v)
 {
-    static C_CallingConvention *c_call      = nullptr;
-    static Pascal_CallingConvention *p_call = nullptr;
-    static Unknown_CallingConvention *u_call= nullptr;
-    if(nullptr==c_call)
-        c_call = new C_CallingConvention;
-    if(nullptr==p_call)
-        p_call = new Pascal_CallingConvention;
-    if(nullptr==u_call)
-        u_call = new Unknown_CallingConvention;
+    static C_CallingConvention *c_call      = new C_CallingConvention;
+    static Pascal_CallingConvention *p_call = new Pascal_CallingConvention;
+    static Unknown_CallingConvention *u_call= new Unknown_CallingConvention;
     switch(v) {
     case eUnknown: return u_call;
     case eCdecl: return c_call;
@@ -9,6 +9,11 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QDebug>
 #include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 
 class Loader
@@ -35,7 +40,7 @@ struct PSP {			/*        PSP structure					*/
     uint8_t cmdTail[0x80];		/* command tail and disk transfer area	*/
 };
 
-static struct MZHeader {				/*      EXE file header		 	 */
+struct MZHeader {				/*      EXE file header		 	 */
     uint8_t     sigLo;			/* .EXE signature: 0x4D 0x5A	 */
     uint8_t     sigHi;
     uint16_t	lastPageSize;	/* Size of the last page		 */
@@ -51,7 +56,8 @@ static struct MZHeader {				/*      EXE file header		 	 */
     uint16_t	initCS;			/* Segment displacement of code  */
     uint16_t	relocTabOffset;	/* Relocation table offset       */
     uint16_t	overlayNum;		/* Overlay number                */
-} header;
+};
+static thread_local MZHeader header;
 
 #define EXE_RELOCATION  0x10		/* EXE images rellocated to above PSP */
 
@@ -189,17 +195,91 @@ bool DccFrontend::FrontEnd ()
         displayMemMap();
     return(true); // we no longer own proj !
 }
+PROG::~PROG()
+{
+    releaseImage();
+    free(map);
+}
+void PROG::releaseImage()
+{
+    if (imageMapping)
+    {
+#ifndef _WIN32
+        munmap(imageMapping, imageMappingSize);
+#endif
+    }
+    else
+        delete [] Imagez;
+    Imagez = nullptr;
+    imageMapping = nullptr;
+    imageMappingSize = 0;
+}
+/* Builds relocBits from the cReloc entries of relocTable */
+void PROG::indexRelocations()
+{
+    relocBits.clear();
+    for (int i = 0; i < cReloc; i++)
+    {
+        uint32_t off = relocTable[i];
+        if (off/64 >= relocBits.size())
+            relocBits.resize(off/64 + 1, 0);
+        relocBits[off/64] |= uint64_t(1) << (off%64);
+    }
+}
+/*****************************************************************************
+ * mapImage - makes the sz bytes of the file at offset start appear at image
+ * offset skip, the skip bytes in front of them being zeroed.  The mapping is
+ * private, so the PSP and relocation fixups later written into the image
+ * only copy the pages they touch and the rest is shared with the page cache.
+ * Returns false if the file cannot be mapped, the loader then reads it.
+ ****************************************************************************/
+static bool mapImage(PROG &prog, QFile &fp, qint64 start, size_t sz, size_t skip)
+{
+#ifndef _WIN32
+    if (option.ReadImage or sz == 0 or start + qint64(sz) > fp.size())
+        return false;
+    const size_t page  = size_t(sysconf(_SC_PAGESIZE));
+    const size_t lead  = size_t(start) % page;     /* File bytes mapped before the image data */
+    const size_t front = (skip > lead) ? (skip - lead + page - 1) / page * page : 0;
+    const size_t fileLen = (lead + sz + page - 1) / page * page;
+    /* Reserve room for the anonymous pages in front, then lay the file over
+     * the rest of it */
+    uint8_t *base = (uint8_t *)mmap(nullptr, front + fileLen, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+        return false;
+    if (mmap(base + front, fileLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+             fp.handle(), off_t(start - lead)) == MAP_FAILED)
+    {
+        munmap(base, front + fileLen);
+        return false;
+    }
+    prog.imageMapping = base;
+    prog.imageMappingSize = front + fileLen;
+    prog.Imagez = base + front + lead - skip;
+    memset(prog.Imagez, 0, skip);
+    return true;
+#else
+    return false;
+#endif
+}
 struct DosLoader {
 protected:
     void prepareImage(PROG &prog,size_t sz,QFile &fp) {
-        /* Allocate a block of memory for the program. */
+        prog.releaseImage();
         prog.cbImage  = sz + sizeof(PSP);
-        prog.Imagez    = new uint8_t [prog.cbImage];
+        /* Map the image past where a PSP would go, or allocate a block of
+         * memory for the program and read it in */
+        if (not mapImage(prog, fp, fp.pos(), sz, sizeof(PSP)))
+        {
+            prog.Imagez    = new uint8_t [prog.cbImage];
+            memset(prog.Imagez, 0, sizeof(PSP));
+            if (qint64(sz) != fp.read((char *)prog.Imagez + sizeof(PSP),sz))
+                fatalError(CANNOT_READ, fp.fileName().toLocal8Bit().data());
+        }
         prog.Imagez[0] = 0xCD;		/* Fill in PSP int 20h location */
         prog.Imagez[1] = 0x20;		/* for termination checking     */
-        /* Read in the image past where a PSP would go */
-        if (sz != fp.read((char *)prog.Imagez + sizeof(PSP),sz))
-            fatalError(CANNOT_READ, fp.fileName().toLocal8Bit().data());
+        prog.indexRelocations();
     }
 };
 struct ComLoader : public DosLoader {
@@ -342,8 +422,11 @@ struct RomLoader {
 protected:
     void prepareImage(PROG &prog, size_t sz, QFile &fp)
     {
-        /* Allocate a block of memory for the program. */
+        prog.releaseImage();
         prog.cbImage = sz;
+        if (mapImage(prog, fp, 0, sz, 0))
+            return;
+        /* Allocate a block of memory for the program. */
         prog.Imagez = new uint8_t[prog.cbImage];
 
         if (sz != fp.read((char *)prog.Imagez, sz))
@@ -440,6 +523,7 @@ struct ExeLoader : public DosLoader {
 ****************************************************************************/
 bool Project::load()
 {
+    PhaseTimer timer(PH_LOAD);
     // addTask(loaderSelection,PreCond(BinaryImage))
     // addTask(applyLoader,PreCond(Loader))
     const char *fname = binary_path().toLocal8Bit().data();
@@ -473,7 +557,7 @@ bool Project::load()
     }
     return false;
 }
-uint32_t SynthLab;
+thread_local uint32_t SynthLab;
 /* Parses the program, builds the call graph, and returns the list of
  * procedures found     */
 void DccFrontend::parse(Project &proj)
@@ -497,12 +581,11 @@ void DccFrontend::parse(Project &proj)
     /* Make a struct for the initial procedure */
     if (prog.offMain != -1)
     {
-        start_proc = proj.createFunction(0,"main");
+        /* We know where main() is. Start the flow of control from there */
+        start_proc = proj.createFunction(0,"main",prog.offMain);
         start_proc->retVal.loc = REG_FRAME;
         start_proc->retVal.type = TYPE_WORD_SIGN;
         start_proc->retVal.id.regi = rAX;
-        /* We know where main() is. Start the flow of control from there */
-        start_proc->procEntry = prog.offMain;
         /* In medium and large models, the segment of main may (will?) not be
             the same as the initial CS segment (of the startup code) */
         state.setState(rCS, prog.segMain);
@@ -510,17 +593,15 @@ void DccFrontend::parse(Project &proj)
     }
     else
     {
-        start_proc = proj.createFunction(0,"start");
         /* Create initial procedure at program start address */
-        start_proc->procEntry = (uint32_t)state.IP;
+        start_proc = proj.createFunction(0,"start",(uint32_t)state.IP);
     }
 
     /* The state info is for the first procedure */
     start_proc->state = state;
 
     /* Set up call graph initial node */
-    proj.callGraph = new CALL_GRAPH;
-    proj.callGraph->proc = start_proc;
+    proj.callGraph = new CALL_GRAPH(start_proc);
 
     /* This proc needs to be called to set things up for LibCheck(), which
        checks a proc to see if it is a know C (etc) library */
@@ -528,7 +609,10 @@ void DccFrontend::parse(Project &proj)
     //BUG:  proj and g_proj are 'live' at this point !
 
     /* Recursively build entire procedure list */
-    start_proc->FollowCtrl(proj.callGraph, &state);
+    {
+        PhaseTimer timer(PH_PARSE);
+        start_proc->FollowCtrl(proj.callGraph, &state);
+    }
 
     /* This proc needs to be called to clean things up from SetupLibCheck() */
     CleanupLibCheck();
@@ -0,0 +1,96 @@
+/*
+ * File:    DominatorTree.cpp
+ * Purpose: Immediate dominators and dominator tree of a procedure's graph
+ */
+
+#include "DominatorTree.h"
+
+#include "dcc.h"
+
+#include <utility>
+
+/* Nearest common dominator of a and b, walking up from whichever is later
+ * in reverse postorder */
+int DominatorTree::intersect(int a, int b) const
+{
+    if (a == NO_DOM)
+        return b;
+    if (b == NO_DOM)    /* b is the root */
+        return a;
+    while ((a != NO_DOM) and (b != NO_DOM) and (a != b))
+    {
+        if (a < b)
+            b = m_idom[b];
+        else
+            a = m_idom[a];
+    }
+    return a;
+}
+
+void DominatorTree::build(Function &f)
+{
+    size_t numBBs = f.numBBs;
+    m_idom.resize(numBBs);
+    for (size_t i = 0; i < numBBs; i++)
+        m_idom[i] = f.m_dfsLast[i]->immedDom;
+
+    /* Back edges go to a node earlier in reverse postorder; they do not
+     * change the dominators of a reducible graph */
+    for (size_t currIdx = 0; currIdx < numBBs; currIdx++)
+    {
+        BB *currNode = f.m_dfsLast[currIdx];
+        if (currNode->flg & INVALID_BB)		/* Do not process invalid BBs */
+            continue;
+        int idom = m_idom[currIdx];
+        for (BB *inedge : currNode->inEdges)
+        {
+            size_t predIdx = inedge->dfsLastNum;
+            if (predIdx < currIdx)
+                idom = intersect(idom, int(predIdx));
+        }
+        m_idom[currIdx] = idom;
+        currNode->immedDom = idom;
+    }
+    number();
+}
+
+/* Builds the tree and numbers it in preorder and postorder.  Invalid nodes
+ * and the root have no dominator, each starts a tree of its own. */
+void DominatorTree::number()
+{
+    size_t numBBs = m_idom.size();
+    m_children.assign(numBBs, std::vector<int>());
+    std::vector<int> roots;
+    for (size_t i = 0; i < numBBs; i++)
+    {
+        if (m_idom[i] == NO_DOM or size_t(m_idom[i]) >= numBBs)
+            roots.push_back(int(i));
+        else
+            m_children[m_idom[i]].push_back(int(i));
+    }
+
+    m_pre.assign(numBBs, 0);
+    m_post.assign(numBBs, 0);
+    int pre = 0, post = 0;
+    std::vector<std::pair<int,size_t> > stack;  /* Node, next child */
+    for (int root : roots)
+    {
+        m_pre[root] = pre++;
+        stack.emplace_back(root, 0);
+        while (not stack.empty())
+        {
+            std::pair<int,size_t> &top(stack.back());
+            if (top.second < m_children[top.first].size())
+            {
+                int child = m_children[top.first][top.second++];
+                m_pre[child] = pre++;
+                stack.emplace_back(child, 0);
+            }
+            else
+            {
+                m_post[top.first] = post++;
+                stack.pop_back();
+            }
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * File:    ExprArena.cpp
+ * Purpose: Bulk allocation of expression nodes
+ */
+
+#include "ExprArena.h"
+
+#include "ast.h"
+#include "project.h"
+
+thread_local ExprArena *ExprArena::s_current = nullptr;
+
+Constant *ExprArena::constant(uint32_t kte, uint8_t size)
+{
+    Constant *&c(m_constants[(uint64_t(kte) << 8) | size]);
+    if (c)
+        m_shared++;
+    else
+        c = new (allocate(sizeof(Constant))) Constant(kte, size);
+    return c;
+}
+
+RegisterNode *ExprArena::reg(int regiIdx, regType type, const LOCAL_ID *syms)
+{
+    RegisterNode *&r(m_registers[RegKey{syms, regiIdx, type}]);
+    if (r)
+        m_shared++;
+    else
+        r = new (allocate(sizeof(RegisterNode))) RegisterNode(regiIdx, type, syms);
+    return r;
+}
+
+/* Nodes built outside any procedure's analysis, by serial code only, go to
+ * the project */
+ExprArena &ExprArena::current()
+{
+    if (s_current)
+        return *s_current;
+    return Project::get()->exprs;
+}
+
+ExprArena::Scope::Scope(ExprArena &arena) : m_prev(s_current)
+{
+    s_current = &arena;
+}
+
+ExprArena::Scope::~Scope()
+{
+    s_current = m_prev;
+}
+
+void *Expr::operator new(size_t size)
+{
+    return ExprArena::current().allocate(size);
+}
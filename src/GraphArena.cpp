@@ -0,0 +1,14 @@
+/*
+ * File:    GraphArena.cpp
+ * Purpose: Bulk allocation of BBs, intervals and derived sequences
+ */
+
+#include "GraphArena.h"
+
+void GraphArena::release()
+{
+    for (auto iter = m_objects.rbegin(); iter != m_objects.rend(); ++iter)
+        iter->destroy(iter->ptr);
+    m_objects.clear();
+    reset();
+}
@@ -0,0 +1,280 @@
+/*
+ * File:    Profiler.cpp
+ * Purpose: Timing and memory figures of each decompilation phase
+ */
+
+#include "Profiler.h"
+
+#include "dcc.h"
+#include "project.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <time.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include <QtCore/QFile>
+
+static bool s_enabled = false;
+/* Allocations made by this thread */
+static thread_local uint64_t tl_allocs = 0;
+static thread_local uint64_t tl_allocBytes = 0;
+/* This thread's figures when it last changed program */
+static thread_local double tl_creditedCpu = 0;
+static thread_local uint64_t tl_creditedAllocs = 0;
+static thread_local uint64_t tl_creditedBytes = 0;
+/* Innermost procedure timer running on this thread */
+static thread_local PhaseTimer *tl_procTimer = nullptr;
+
+void PhaseSample::add(const PhaseSample &o)
+{
+    wall += o.wall;
+    cpu += o.cpu;
+    allocs += o.allocs;
+    allocBytes += o.allocBytes;
+    if (o.peakRss > peakRss)
+        peakRss = o.peakRss;
+}
+
+void PhaseSample::subtract(const PhaseSample &o)
+{
+    wall -= o.wall;
+    cpu -= o.cpu;
+    allocs -= o.allocs;
+    allocBytes -= o.allocBytes;
+}
+
+static double wallClock()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+/* CPU time of this thread (of the process on Windows) */
+static double cpuClock()
+{
+#ifndef _WIN32
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+#else
+    return double(clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+static long peakRss()
+{
+#ifndef _WIN32
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+/* The counters now: of this thread for a procedure, else of the current
+ * program, this thread's uncredited part included */
+static PhaseSample now(bool perProc)
+{
+    PhaseSample res;
+    res.wall = wallClock();
+    res.cpu = cpuClock();
+    res.allocs = tl_allocs;
+    res.allocBytes = tl_allocBytes;
+    if (not perProc)
+    {
+        const ProgramUsage &usage(Project::get()->usage);
+        res.cpu += usage.cpuNs.load(std::memory_order_relaxed) * 1e-9 - tl_creditedCpu;
+        res.allocs += usage.allocs.load(std::memory_order_relaxed) - tl_creditedAllocs;
+        res.allocBytes += usage.allocBytes.load(std::memory_order_relaxed) - tl_creditedBytes;
+    }
+    return res;
+}
+
+PhaseTimer::PhaseTimer(ePhase phase, Function *proc) : m_phase(phase), m_proc(proc), m_on(s_enabled),
+    m_outer(nullptr)
+{
+    if (not m_on)
+        return;
+    if (m_proc)
+    {
+        m_outer = tl_procTimer;
+        tl_procTimer = this;
+        if (m_proc->profile.empty())
+            m_proc->profile.resize(PH_COUNT);
+    }
+    m_start = now(m_proc != nullptr);
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    stop();
+}
+
+void PhaseTimer::stop()
+{
+    if (not m_on)
+        return;
+    m_on = false;
+    PhaseSample spent = now(m_proc != nullptr);
+    spent.subtract(m_start);
+    if (m_proc == nullptr)
+    {
+        spent.peakRss = peakRss();
+        Project::get()->profile[m_phase].add(spent);
+        return;
+    }
+    tl_procTimer = m_outer;
+    if (m_outer and m_outer->m_phase == m_phase)
+        m_outer->m_nested.add(spent);
+    spent.subtract(m_nested);
+    m_proc->profile[m_phase].add(spent);
+}
+
+void Profiler::countAllocation(size_t size)
+{
+    if (not s_enabled)
+        return;
+    tl_allocs++;
+    tl_allocBytes += size;
+}
+
+void Profiler::creditThread(Project *proj)
+{
+    if (not s_enabled)
+        return;
+    double cpu = cpuClock();
+    if (proj)
+    {
+        proj->usage.cpuNs.fetch_add(uint64_t((cpu - tl_creditedCpu) * 1e9), std::memory_order_relaxed);
+        proj->usage.allocs.fetch_add(tl_allocs - tl_creditedAllocs, std::memory_order_relaxed);
+        proj->usage.allocBytes.fetch_add(tl_allocBytes - tl_creditedBytes, std::memory_order_relaxed);
+    }
+    tl_creditedCpu = cpu;
+    tl_creditedAllocs = tl_allocs;
+    tl_creditedBytes = tl_allocBytes;
+}
+
+void Profiler::enable()
+{
+    s_enabled = true;
+}
+
+bool Profiler::enabled()
+{
+    return s_enabled;
+}
+
+const char *Profiler::phaseName(ePhase phase)
+{
+    static const char *names[PH_COUNT] = {
+        "load", "FollowCtrl", "buildCFG", "lowLevelAnalysis", "dataFlow",
+        "controlFlowAnalysis", "codeGen"
+    };
+    return names[phase];
+}
+
+static void appendString(std::string &out, const QString &s)
+{
+    out += '"';
+    for (char c : s.toStdString())
+    {
+        if (c == '"' or c == '\\')
+            out += '\\';
+        if (uint8_t(c) < 0x20)
+        {
+            char esc[8];
+            sprintf(esc, "\\u%04x", c);
+            out += esc;
+        }
+        else
+            out += c;
+    }
+    out += '"';
+}
+
+static void appendSample(std::string &out, const PhaseSample &s, bool withRss)
+{
+    char buf[200];
+    sprintf(buf, "{\"wall\": %.6f, \"cpu\": %.6f, \"allocs\": %llu, \"alloc_bytes\": %llu",
+            s.wall, s.cpu, (unsigned long long)s.allocs, (unsigned long long)s.allocBytes);
+    out += buf;
+    if (withRss)
+    {
+        sprintf(buf, ", \"peak_rss_kb\": %ld", s.peakRss);
+        out += buf;
+    }
+    out += '}';
+}
+
+PhaseSample Profiler::phaseTotal(const Project &proj, ePhase phase)
+{
+    if (phase != PH_LOW_LEVEL)
+        return proj.profile[phase];
+    PhaseSample res;
+    for (const Function &f : proj.functions())
+        if (not f.profile.empty())
+            res.add(f.profile[phase]);
+    return res;
+}
+
+std::string Profiler::toJson(const Project &proj)
+{
+    std::string out("{\"input\": ");
+    appendString(out, proj.binary_path());
+    char buf[64];
+    sprintf(buf, ", \"jobs\": %u,\n  \"phases\": {", proj.procJobs());
+    out += buf;
+    for (int ph = 0; ph < PH_COUNT; ph++)
+    {
+        out += ph ? ",\n    \"" : "\n    \"";
+        out += phaseName(ePhase(ph));
+        out += "\": ";
+        appendSample(out, phaseTotal(proj, ePhase(ph)), ph != PH_LOW_LEVEL);
+    }
+    out += "},\n  \"procedures\": [";
+    bool first = true;
+    for (const Function &f : proj.functions())
+    {
+        if (f.profile.empty())
+            continue;
+        out += first ? "\n    {\"name\": " : ",\n    {\"name\": ";
+        first = false;
+        appendString(out, f.name);
+        sprintf(buf, ", \"entry\": %u", f.procEntry);
+        out += buf;
+        for (int ph = PH_PARSE; ph < PH_COUNT; ph++)   /* Loading is not per procedure */
+        {
+            out += ", \"";
+            out += phaseName(ePhase(ph));
+            out += "\": ";
+            appendSample(out, f.profile[ph], false);
+        }
+        out += '}';
+    }
+    out += "]}";
+    return out;
+}
+
+bool Profiler::write(const QString &fname, const std::vector<std::string> &programs)
+{
+    QFile file(fname);
+    if (not file.open(QFile::WriteOnly | QFile::Text))
+    {
+        fprintf(stderr, "dcc: cannot write profile %s\n", qPrintable(fname));
+        return false;
+    }
+    std::string out("{\"programs\": [\n  ");
+    for (size_t i = 0; i < programs.size(); i++)
+    {
+        if (i)
+            out += ",\n  ";
+        out += programs[i];
+    }
+    out += "\n]}\n";
+    file.write(out.data(), qint64(out.size()));
+    return true;
+}
@@ -1,6 +1,7 @@
 #include "types.h"
 #include "msvc_fixes.h"
 #include "ast.h"
+#include "ExprArena.h"
 #include "bundle.h"
 #include "machine_x86.h"
 #include "project.h"
@@ -17,10 +18,8 @@
 
 using namespace std;
 using namespace boost::adaptors;
-RegisterNode::RegisterNode(const LLOperand &op, LOCAL_ID *locsym)
+RegisterNode *RegisterNode::Create(const LLOperand &op, LOCAL_ID *locsym)
 {
-    m_syms = locsym;
-    ident.type(REGISTER);
     hlType type_sel;
     regType reg_type;
     if (op.byteWidth()==1)
@@ -33,8 +32,12 @@ RegisterNode::RegisterNode(const LLOperand &op, LOCAL_ID *locsym)
         type_sel = TYPE_WORD_SIGN;
         reg_type = WORD_REG;
     }
-    regiIdx = locsym->newByteWordReg(type_sel, op.regi);
-    regiType = reg_type;
+    return Create(locsym->newByteWordReg(type_sel, op.regi), reg_type, locsym);
+}
+
+RegisterNode *RegisterNode::Create(int idx, regType reg_type, const LOCAL_ID *syms)
+{
+    return ExprArena::current().reg(idx, reg_type, syms);
 }
 
 //RegisterNode::RegisterNode(eReg regi, uint32_t icodeFlg, LOCAL_ID *locsym)
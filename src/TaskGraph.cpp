@@ -0,0 +1,98 @@
+/*
+ * File:    TaskGraph.cpp
+ * Purpose: Dependency ordered execution of tasks on a pool of threads
+ */
+
+#include "TaskGraph.h"
+
+#include "project.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+int TaskGraph::addTask(const Task &t)
+{
+    m_nodes.emplace_back();
+    m_nodes.back().task = t;
+    return int(m_nodes.size()) - 1;
+}
+
+void TaskGraph::addDependency(int before, int after)
+{
+    m_nodes[before].successors.push_back(after);
+    m_nodes[after].numPreds++;
+}
+
+unsigned TaskGraph::hardwareJobs()
+{
+    unsigned res = std::thread::hardware_concurrency();
+    return res ? res : 1;
+}
+
+/* Executes every task, a task being started only after all its predecessors
+ * have completed.  Ready tasks are handed out in the order they became ready;
+ * with jobs <= 1 this is a plain topological walk on the calling thread.
+ * Tasks run on the calling thread's current Project, whichever thread
+ * they run on. */
+void TaskGraph::run(unsigned jobs)
+{
+    std::deque<int> ready;
+    for (size_t i = 0; i < m_nodes.size(); i++)
+        if (m_nodes[i].numPreds == 0)
+            ready.push_back(int(i));
+
+    if (jobs <= 1)
+    {
+        while (not ready.empty())
+        {
+            Node &n(m_nodes[ready.front()]);
+            ready.pop_front();
+            n.task();
+            for (int succ : n.successors)
+                if (--m_nodes[succ].numPreds == 0)
+                    ready.push_back(succ);
+        }
+        m_nodes.clear();
+        return;
+    }
+
+    std::mutex              lock;
+    std::condition_variable wakeup;
+    size_t                  remaining = m_nodes.size();
+    auto worker = [&]()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;)
+        {
+            wakeup.wait(guard, [&]() { return remaining == 0 or not ready.empty(); });
+            if (ready.empty())
+                return;                         /* Everything has been run */
+            Node &n(m_nodes[ready.front()]);
+            ready.pop_front();
+            guard.unlock();
+            n.task();
+            guard.lock();
+            for (int succ : n.successors)
+                if (--m_nodes[succ].numPreds == 0)
+                    ready.push_back(succ);
+            if (--remaining == 0 or not n.successors.empty())
+                wakeup.notify_all();
+        }
+    };
+    if (jobs > m_nodes.size())
+        jobs = unsigned(m_nodes.size());
+    Project *proj = Project::get();
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < jobs; i++)
+        pool.emplace_back([&worker, proj]() {
+            Project::setCurrent(proj);
+            worker();
+            Project::setCurrent(nullptr);
+        });
+    worker();
+    for (std::thread &t : pool)
+        t.join();
+    m_nodes.clear();
+}
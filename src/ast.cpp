@@ -11,6 +11,7 @@
 #include "bundle.h"
 #include "machine_x86.h"
 #include "project.h"
+#include "ExprArena.h"
 
 #include <QtCore/QTextStream>
 #include <QtCore/QDebug>
@@ -49,7 +50,7 @@ constexpr const int hlSize[] = {2, 1, 1, 2, 2, 4, 4, 4, 2, 2, 1, 4, 4};
 /* Returns the integer i in C hexadecimal format */
 const char *hexStr (uint16_t i)
 {
-    static char buf[10];
+    static thread_local char buf[10];
     sprintf (buf, "%s%x", (i > 9) ? "0x" : "", i);
     return buf;
 }
@@ -150,12 +151,7 @@ AstIdent *AstIdent::Loc(int off, LOCAL_ID *localId)
     size_t i;
     AstIdent *newExp = new AstIdent();
     newExp->ident.idType = LOCAL_VAR;
-    for (i = 0; i < localId->csym(); i++)
-    {
-        const ID &lID(localId->id_arr[i]);
-        if ((lID.id.bwId.off == off) and (lID.id.bwId.regOff == 0))
-            break;
-    }
+    i = localId->findByteWordStk(off, 0);
     if (i == localId->csym())
         printf ("Error, cannot find local var\n");
     newExp->ident.idNode.localIdx = i;
@@ -174,7 +170,7 @@ AstIdent *AstIdent::Param(int off, const STKFRAME * argSymtab)
     auto iter=argSymtab->findByLabel(off);
     if (iter == argSymtab->end())
         printf ("Error, cannot find argument var\n");
-    newExp->ident.idNode.localIdx = distance(argSymtab->begin(),iter);
+    newExp->ident.idNode.localIdx = std::distance(argSymtab->begin(),iter);
     return (newExp);
 }
 
@@ -185,12 +181,7 @@ GlobalVariableIdx::GlobalVariableIdx (int16_t segValue, int16_t off, uint8_t reg
 {
     size_t i;
     ident.type(GLOB_VAR_IDX);
-    for (i = 0; i < locSym->csym(); i++)
-    {
-        const BWGLB_TYPE &lID(locSym->id_arr[i].id.bwGlb);
-        if ((lID.seg == segValue) and (lID.off == off) and (lID.regi == regi))
-            break;
-    }
+    i = locSym->findIntIdx(segValue, off, eReg(regi));
     if (i == locSym->csym())
         printf ("Error, indexed-glob var not found in local id table\n");
     idxGlbIdx = i;
@@ -233,7 +224,7 @@ AstIdent *AstIdent::Long(LOCAL_ID *localId, opLoc sd, iICODE pIcode, hlFirst f,
             value = (pIcode->ll()->src().getImm2() << 16) + atOffset.src().getImm2();
         else/* LOW_FIRST */
             value = (atOffset.src().getImm2() << 16)+ pIcode->ll()->src().getImm2();
-        newExp = new Constant(value,4);
+        newExp = Constant::Create(value,4);
     }
     /* Save it as a long expression (reg, stack or glob) */
     else
@@ -276,10 +267,10 @@ AstIdent *AstIdent::idID (const ID *retVal, LOCAL_ID *locsym, iICODE ix_)
         }
         case TYPE_WORD_UNSIGN:
         case TYPE_WORD_SIGN:
-            newExp = new RegisterNode(locsym->newByteWordReg(retVal->type, retVal->id.regi),WORD_REG,locsym);
+            newExp = RegisterNode::Create(locsym->newByteWordReg(retVal->type, retVal->id.regi),WORD_REG,locsym);
             break;
         case TYPE_BYTE_SIGN:
-            newExp = new RegisterNode(locsym->newByteWordReg(retVal->type, retVal->id.regi),BYTE_REG,locsym);
+            newExp = RegisterNode::Create(locsym->newByteWordReg(retVal->type, retVal->id.regi),BYTE_REG,locsym);
             break;
         default:
             fprintf(stderr,"AstIdent::idID unhandled type %d\n",retVal->type);
@@ -313,18 +304,18 @@ Expr *AstIdent::id(const LLInst &ll_insn, opLoc sd, Function * pProc, iICODE ix_
     
     else if ((sd == DST) and ll_insn.testFlags(IM_TMP_DST))
     {                                                   /* implicit tmp */
-        newExp = new RegisterNode(LLOperand(rTMP,2), &pProc->localId);
+        newExp = RegisterNode::Create(LLOperand(rTMP,2), &pProc->localId);
         duIcode.setRegDU(rTMP, (operDu)eUSE);
     }
     
     else if ((sd == SRC) and ll_insn.testFlags(I)) /* constant */
-        newExp = new Constant(ll_insn.src().getImm2(), 2);
+        newExp = Constant::Create(ll_insn.src().getImm2(), 2);
     else if (pm.regi == rUNDEF) /* global variable */
         newExp = new GlobalVariable(pm.segValue, pm.off);
     else if ( pm.isReg() )      /* register */
     {
         //(sd == SRC) ? ll_insn.getFlag() : ll_insn.getFlag() & NO_SRC_B
-        newExp = new RegisterNode(pm, &pProc->localId);
+        newExp = RegisterNode::Create(pm, &pProc->localId);
         duIcode.setRegDU( pm.regi, du);
     }
     
@@ -364,7 +355,7 @@ Expr *AstIdent::id(const LLInst &ll_insn, opLoc sd, Function * pProc, iICODE ix_
                     assert(false);
             }
             //NOTICE: was selected, 0
-            newExp = new RegisterNode(LLOperand(selected, 0), &pProc->localId);
+            newExp = RegisterNode::Create(LLOperand(selected, 0), &pProc->localId);
             duIcode.setRegDU( selected, du);
             newExp = UnaryOperator::Create(DEREFERENCE, newExp);
         }
@@ -853,8 +844,12 @@ Expr *AstIdent::performLongRemoval(eReg regi, LOCAL_ID *locId)
         return this;
     otherRegi = locId->getPairedRegisterAt(ident.idNode.longIdx,regi);
     bool long_was_signed = locId->id_arr[ident.idNode.longIdx].isSigned();
-    delete this;
-    return new RegisterNode(locId->newByteWordReg(long_was_signed ? TYPE_WORD_SIGN : TYPE_WORD_UNSIGN,otherRegi),WORD_REG,locId);
+    return RegisterNode::Create(locId->newByteWordReg(long_was_signed ? TYPE_WORD_SIGN : TYPE_WORD_UNSIGN,otherRegi),WORD_REG,locId);
+}
+
+Constant *Constant::Create(uint32_t _kte, uint8_t size)
+{
+    return ExprArena::current().constant(_kte, size);
 }
 
 QString Constant::walkCondExpr(Function *, int *) const
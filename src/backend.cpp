@@ -9,6 +9,7 @@
 #include "disassem.h"
 #include "project.h"
 #include "CallGraph.h"
+#include "TaskGraph.h"
 
 #include <QtCore/QDir>
 #include <QtCore/QFile>
@@ -30,13 +31,13 @@ using namespace boost;
 using namespace boost::adaptors;
 using namespace std;
 
-bundle cCode;			/* Procedure declaration and code */
+thread_local bundle cCode;	/* Procedure declaration and code */
 
-/* Returns a unique index to the next label */
+/* Returns the index of the next label of the procedure being generated,
+ * writeBundle turns it into the label's number in the file */
 int getNextLabel()
 {
-    static int labelIdx = 1;	/* index of the next label		*/
-    return (labelIdx++);
+    return (cCode.labels++);
 }
 
 
@@ -52,6 +53,8 @@ void Function::displayStats ()
         qDebug() << QString("  Percentage reduction: %1%%").arg(100.0 - (stats.numHLIcode *
                                                               100.0) / stats.numLLIcode,4,'f',2,QChar('0'));
     }
+    qDebug() << "Expression nodes:" << exprs.nodes() << "in" << exprs.bytes() << "bytes,"
+             << exprs.sharedLeaves() << "leaves shared";
 }
 
 
@@ -79,7 +82,7 @@ static void fixupLabels (PPROC pProc)
  * constants such as carriage return and line feed, require 2 C characters. */
 char *cChar (uint8_t c)
 {
-    static char res[3];
+    static thread_local char res[3];
 
     switch (c) {
         case 0x8:		/* backspace */
@@ -190,7 +193,6 @@ static void writeHeader (QIODevice &_ios, const std::string &fileName)
     /* Write global symbol table */
     /** writeGlobSymTable(); *** need to change them into locident fmt ***/
     writeBundle (_ios, cCode);
-    freeBundle (&cCode);
 }
 
 // Note: Not currently called!
@@ -213,8 +215,9 @@ static void emitFwdGotoLabel (ICODE * pt, int indLevel)
 #endif
 
 /* Writes the procedure's declaration (including arguments), local variables,
- * and invokes the procedure that writes the code of the given record *hli */
-void Function::codeGen (QIODevice &fs)
+ * and invokes the procedure that writes the code of the given record *hli.
+ * Everything goes to cCode, for writeBundle to write out. */
+void Function::codeGen ()
 {
     int numLoc;
     QString ostr_contents;
@@ -223,6 +226,8 @@ void Function::codeGen (QIODevice &fs)
     //char buf[200],        /* Procedure's definition           */
     //        arg[30];         /* One argument                     */
     BB *pBB;              /* Pointer to basic block           */
+    PhaseTimer timer(PH_CODE_GEN, this);
+    ExprArena::Scope exprScope(exprs);
 
     /* Write procedure/function header */
     cCode.init();
@@ -276,7 +281,7 @@ void Function::codeGen (QIODevice &fs)
         }
     }
     ostr.flush();
-    fs.write(ostr_contents.toLatin1());
+    cCode.head.append(ostr_contents);
 
     /* Write procedure's code */
     if (flg & PROC_ASM)		/* generate assembler */
@@ -290,8 +295,6 @@ void Function::codeGen (QIODevice &fs)
     }
 
     cCode.appendCode( "}\n\n");
-    writeBundle (fs, cCode);
-    freeBundle (&cCode);
 
     /* Write Live register analysis information */
     if (option.verbose) {
@@ -320,44 +323,83 @@ void Function::codeGen (QIODevice &fs)
 }
 
 
-/* Recursive procedure. Displays the procedure's code in depth-first order
- * of the call graph.	*/
-static void backBackEnd (CALL_GRAPH * pcallGraph, QIODevice &_ios)
+/* Recursive procedure. Lists the procedures to output in depth-first order
+ * of the call graph, the order their code is written in.	*/
+static void backBackEnd (CALL_GRAPH * pcallGraph, int node, bool expand, std::vector<Function *> &order)
 {
+    Function *pProc = &(*pcallGraph->nodes[node].proc);
 
     //	IFace.Yield();			/* This is a good place to yield to other apps */
 
     /* Check if this procedure has been processed already */
-    if ((pcallGraph->proc->flg & PROC_OUTPUT) or
-        (pcallGraph->proc->flg & PROC_ISLIB))
+    if ((pProc->flg & PROC_OUTPUT) or
+        (pProc->flg & PROC_ISLIB))
         return;
-    pcallGraph->proc->flg |= PROC_OUTPUT;
+    pProc->flg |= PROC_OUTPUT;
 
     /* Dfs if this procedure has any successors */
-    for (auto & elem : pcallGraph->outEdges)
-    {
-        backBackEnd (elem, _ios);
-    }
+    if (expand)
+        for (int callee : pcallGraph->nodes[node].outEdges)
+        {
+            backBackEnd (pcallGraph, callee, pcallGraph->expands(node, callee), order);
+        }
+    order.push_back(pProc);
+}
 
-    /* Generate code for this procedure */
-    stats.numLLIcode = pcallGraph->proc->Icode.size();
-    stats.numHLIcode = 0;
-    pcallGraph->proc->codeGen (_ios);
+/* Writes the code generated for pProc, which made numHLIcode high-level
+ * icodes, and its statistics */
+static void writeProc (QIODevice &_ios, Function *pProc, bundle &procCode, int numHLIcode)
+{
+    writeBundle (_ios, procCode);
 
     /* Generate statistics */
+    stats.numLLIcode = pProc->Icode.size();
+    stats.numHLIcode = numHLIcode;
     if (option.Stats)
-        pcallGraph->proc->displayStats ();
-    if (not (pcallGraph->proc->flg & PROC_ASM))
+        pProc->displayStats ();
+    if (not (pProc->flg & PROC_ASM))
     {
         stats.totalLL += stats.numLLIcode;
         stats.totalHL += stats.numHLIcode;
     }
 }
 
+/* Procedures are generated concurrently when asked to, but never when the
+ * generation itself prints (live register dumps). */
+static bool parallelBackEnd()
+{
+    return Project::get()->procJobs() > 1 and not (option.verbose or option.VeryVerbose);
+}
+
+/* Generates every procedure of order on the project's threads, each into its
+ * own bundle, then writes them in order.  Labels are numbered as the
+ * bundles are written, so the file is the same as when generated serially. */
+static void parallelCodeGen (QIODevice &_ios, const std::vector<Function *> &order)
+{
+    std::vector<bundle> procCode(order.size());
+    std::vector<int> numHLIcode(order.size());
+    TaskGraph tasks;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        tasks.addTask([&order,&procCode,&numHLIcode,i]() {
+            stats.numLLIcode = order[i]->Icode.size();
+            stats.numHLIcode = 0;
+            order[i]->codeGen ();
+            numHLIcode[i] = stats.numHLIcode;
+            procCode[i] = std::move(cCode);
+            cCode.init();
+        });
+    }
+    tasks.run(Project::get()->procJobs());
+    for (size_t i = 0; i < order.size(); i++)
+        writeProc (_ios, order[i], procCode[i], numHLIcode[i]);
+}
+
 
 /* Invokes the necessary routines to produce code one procedure at a time. */
 void BackEnd(CALL_GRAPH * pcallGraph)
 {
+    PhaseTimer timer(PH_CODE_GEN);
     /* Get output file name */
     QString outNam(Project::get()->output_name("b")); /* b for beta */
     QFile fs(outNam); /* Output C file 	*/
@@ -369,14 +411,25 @@ void BackEnd(CALL_GRAPH * pcallGraph)
     qDebug()<<"dcc: Writing C beta file"<<outNam;
 
     /* Header information */
-    writeHeader (fs, option.filename.toStdString());
+    writeHeader (fs, Project::get()->binary_path().toStdString());
 
     /* Initialize total Icode instructions statistics */
     stats.totalLL = 0;
     stats.totalHL = 0;
 
     /* Process each procedure at a time */
-    backBackEnd (pcallGraph, fs);
+    std::vector<Function *> order;
+    backBackEnd (pcallGraph, 0, true, order);
+    if (parallelBackEnd())
+        parallelCodeGen (fs, order);
+    else
+        for (Function *pProc : order)
+        {
+            stats.numLLIcode = pProc->Icode.size();
+            stats.numHLIcode = 0;
+            pProc->codeGen ();
+            writeProc (fs, pProc, cCode, stats.numHLIcode);
+        }
 
     /* Close output file */
     fs.close();
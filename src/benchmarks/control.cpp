@@ -0,0 +1,140 @@
+/*
+ * File:    control.cpp
+ * Purpose: Control flow analysis benchmarks - derived sequence and
+ *          structuring of a synthetic procedure of a few thousand basic
+ *          blocks
+ */
+
+#include "dcc.h"
+#include "project.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+/* Builds the graph of a procedure whose body is one while loop, holding a
+ * case statement of numArms arms followed by numIfs if statements:
+ *
+ *      entry -> head -(then)-> case -> arm[i] -> cond[0]
+ *               head -(else)-> ret
+ *      cond[k] -(then)-> then[k] -> cond[k+1], -(else)-> else[k] -> cond[k+1]
+ *      cond[numIfs] (the latching node) -> head
+ *
+ * and numbers it as buildCFG would. */
+Function *createProc(int numArms, int numIfs)
+{
+    enum { ENTRY = 0, HEAD, RET, CASE, FIRST_ARM };
+    int firstCond = FIRST_ARM + numArms;
+    int latch = firstCond + 3 * numIfs;
+    int numNodes = latch + 1;
+
+    Function *f = Function::Create();
+    ICODE icode;
+    icode.type = LOW_LEVEL_ICODE;
+    for (int i = 0; i < numNodes; i++)
+    {
+        icode.ll()->label = uint32_t(i);
+        f->Icode.addIcode(&icode);
+    }
+    std::vector<BB *> nodes(numNodes);
+    auto kindOf = [&](int i) -> eBBKind {
+        if (i == HEAD)
+            return TWO_BRANCH;
+        if (i == RET)
+            return RETURN_NODE;
+        if (i == CASE)
+            return MULTI_BRANCH;
+        if (i >= firstCond and i < latch and (i - firstCond) % 3 == 0)
+            return TWO_BRANCH;
+        return ONE_BRANCH;
+    };
+    for (int i = 0; i < numNodes; i++)
+    {
+        iICODE ic = f->Icode.begin() + i;
+        nodes[i] = BB::Create(boost::make_iterator_range(ic, ic + 1), kindOf(i), f);
+    }
+    auto link = [&](int from, int to) {
+        nodes[from]->addOutEdge(uint32_t(to));
+        nodes[from]->edges.back().BBptr = nodes[to];
+        nodes[to]->inEdges.push_back(nullptr);
+    };
+    link(ENTRY, HEAD);
+    link(HEAD, CASE);
+    link(HEAD, RET);
+    for (int i = 0; i < numArms; i++)
+    {
+        link(CASE, FIRST_ARM + i);
+        link(FIRST_ARM + i, firstCond);
+    }
+    for (int k = 0; k < numIfs; k++)
+    {
+        int cond = firstCond + 3 * k;
+        link(cond, cond + 1);
+        link(cond, cond + 2);
+        link(cond + 1, cond + 3);
+        link(cond + 2, cond + 3);
+    }
+    link(latch, HEAD);
+    f->hasCase = true;
+
+    for (BB *pBB : nodes)
+        pBB->inEdgeCount = int(pBB->inEdges.size());
+    nodes[ENTRY]->index = UN_INIT;
+    f->numBBs = size_t(numNodes);
+    f->m_dfsLast.resize(f->numBBs, nullptr);
+    int first = 0, last = numNodes - 1;
+    nodes[ENTRY]->dfsNumbering(f->m_dfsLast, &first, &last);
+    return f;
+}
+
+/* Builds the derived sequence of the procedure's graph; arg 0 is the number
+ * of basic blocks, as for BM_Structure. */
+void BM_Reducibility(benchmark::State &state)
+{
+    int numBBs = int(state.range(0));
+    int numArms = numBBs / 4;
+    int numIfs = (numBBs - numArms) / 3;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Function *f = createProc(numArms, numIfs);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(f->checkReducibility());
+
+        state.PauseTiming();
+        f->derivedNodes.release();
+        f->freeCFG();
+        delete f;
+        state.ResumeTiming();
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+/* Structures the procedure; arg 0 is the number of basic blocks, a quarter
+ * of them case arms and the rest if statements. */
+void BM_Structure(benchmark::State &state)
+{
+    int numBBs = int(state.range(0));
+    int numArms = numBBs / 4;
+    int numIfs = (numBBs - numArms) / 3;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Function *f = createProc(numArms, numIfs);
+        derSeq *derivedG = f->checkReducibility();
+        state.ResumeTiming();
+
+        f->structure(derivedG);
+
+        state.PauseTiming();
+        f->derivedNodes.release();
+        f->freeCFG();
+        delete f;
+        state.ResumeTiming();
+    }
+    state.SetComplexityN(state.range(0));
+}
+}
+BENCHMARK(BM_Reducibility)->RangeMultiplier(2)->Range(256, 8192)->Complexity()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Structure)->RangeMultiplier(2)->Range(256, 8192)->Complexity()->Unit(benchmark::kMicrosecond);
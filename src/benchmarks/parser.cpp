@@ -0,0 +1,137 @@
+/*
+ * File:    parser.cpp
+ * Purpose: Front end benchmarks - icode label lookups as done by FollowCtrl,
+ *          instruction decoding, signature hashing, and parsing of the
+ *          BENCH*.EXE programs from tests/inputs_base
+ */
+
+#include "dcc.h"
+#include "project.h"
+#include "DccFrontend.h"
+#include "scanner.h"
+#include "SigFile.h"
+
+#include <benchmark/benchmark.h>
+#include <QtCore/QDir>
+#include <QtCore/QStringList>
+
+/* Replays FollowCtrl's access pattern: each decoded instruction is looked up
+ * by its label (the synthetic jump check) before being appended. */
+static void BM_LabelSrch(benchmark::State &state)
+{
+    const uint32_t numIcodes = uint32_t(state.range(0));
+    ICODE icode;
+    icode.type = LOW_LEVEL_ICODE;
+    for (auto _ : state)
+    {
+        CIcodeRec rec;
+        for (uint32_t ip = 0; ip < numIcodes; ip++)
+        {
+            icode.ll()->label = ip * 3;
+            benchmark::DoNotOptimize(rec.labelSrch(icode.ll()->label));
+            rec.addIcode(&icode);
+        }
+        benchmark::DoNotOptimize(rec.alreadyDecoded(numIcodes));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_LabelSrch)->RangeMultiplier(4)->Range(64, 16384)->Complexity();
+
+/* Loads and parses one program, dropping whatever the previous run left in
+ * the project. */
+static void BM_FrontEnd(benchmark::State &state, const QString &path)
+{
+    Project *proj = Project::get();
+    for (auto _ : state)
+    {
+        proj->clearFunctions();
+        proj->symtab.clear();
+        proj->create(path);
+        if (not proj->load())
+        {
+            state.SkipWithError("cannot load input");
+            break;
+        }
+        DccFrontend fe(nullptr);
+        fe.FrontEnd();
+    }
+    state.counters["procs"] = double(proj->pProcList.size());
+}
+
+/* Re-decodes every instruction the parser found in one program, with the
+ * libdisasm based scanner (arg 0) or the legacy state table (arg 1).  The
+ * decode cache is emptied on each iteration, which is then timed for cold
+ * decoding. */
+static void BM_Scan(benchmark::State &state, const QString &path)
+{
+    Project *proj = Project::get();
+    proj->clearFunctions();
+    proj->symtab.clear();
+    proj->create(path);
+    if (not proj->load())
+    {
+        state.SkipWithError("cannot load input");
+        return;
+    }
+    DccFrontend(nullptr).FrontEnd();
+    std::vector<uint32_t> ips;
+    for (Function &f : proj->pProcList)
+        for (ICODE &ic : f.Icode)
+            ips.push_back(ic.ll()->label);
+
+    option.LegacyDecode = state.range(0)!=0;
+    ICODE icode;
+    for (auto _ : state)
+    {
+        proj->decodeCache.clear();
+        for (uint32_t ip : ips)
+            benchmark::DoNotOptimize(scan(ip, icode));
+    }
+    option.LegacyDecode = false;
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(ips.size()));
+}
+
+/* Hashes every pattern of a signature file, one at a time with hash() (arg
+ * 0) or all together with hashBatch() (arg 1), as readsig does. */
+static void BM_LibHash(benchmark::State &state)
+{
+    SigFile sigs;
+    if (not sigs.load("sigs/dccb2s.sig"))
+    {
+        state.SkipWithError("cannot load signatures");
+        return;
+    }
+    std::vector<const uint8_t *> pats;
+    for (uint32_t i = 0; i < sigs.numKeys; i++)
+        pats.push_back(sigs.ht[i].pat);
+    std::vector<int> hashes(pats.size());
+    for (auto _ : state)
+    {
+        if (state.range(0))
+            sigs.hasher.hashBatch(pats.data(), int(pats.size()), hashes.data());
+        else
+            for (size_t i = 0; i < pats.size(); i++)
+                hashes[i] = sigs.hasher.hash(pats[i]);
+        benchmark::DoNotOptimize(hashes.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(pats.size()));
+}
+BENCHMARK(BM_LibHash)->Arg(0)->Arg(1);
+
+int main(int argc, char **argv)
+{
+    /* Signature files are looked up relative to the working directory */
+    QDir::setCurrent(DCC_SOURCE_DIR);
+    QDir corpus(QString(DCC_SOURCE_DIR) + "/tests/inputs_base");
+    for (const QString &name : corpus.entryList(QStringList() << "BENCH*.EXE", QDir::Files))
+    {
+        QString path = corpus.absoluteFilePath(name);
+        benchmark::RegisterBenchmark(qPrintable("BM_FrontEnd/" + name),
+                                     [path](benchmark::State &st) { BM_FrontEnd(st, path); });
+        benchmark::RegisterBenchmark(qPrintable("BM_Scan/" + name),
+                                     [path](benchmark::State &st) { BM_Scan(st, path); })->Arg(0)->Arg(1);
+    }
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
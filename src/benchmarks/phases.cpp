@@ -0,0 +1,318 @@
+/*
+ * File:    phases.cpp
+ * Purpose: Phase benchmark - decompiles the programs of tests/inputs_base in
+ *          process a number of times, reports the median and percentiles of
+ *          each phase's time and allocations, and compares them with a
+ *          baseline saved by an earlier run
+ *
+ * Usage:   dcc_phasebench [-n iterations] [-j jobs] [--save file]
+ *                         [--baseline file] [--tolerance percent]
+ *                         [--min-time ms] [program.EXE...]
+ *
+ * Every figure is kept per program and phase, and for the total over the
+ * programs of an iteration ("total/<phase>").  With --baseline, a median
+ * wall time more than --tolerance percent above the baseline's, where the
+ * baseline took at least --min-time, or a median allocation count more than
+ * --tolerance percent above it, is a regression, and the exit status is 1.
+ */
+
+#include "dcc.h"
+#include "project.h"
+#include "DccFrontend.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* One value per iteration */
+struct Figures
+{
+    std::vector<double> wall;   /* ms */
+    std::vector<double> cpu;    /* ms */
+    std::vector<double> allocs;
+};
+
+/* What a saved run holds for one program and phase */
+struct Summary
+{
+    double  wallMedian;
+    double  wallP90;
+    double  cpuMedian;
+    double  allocsMedian;
+};
+
+static std::vector<std::string> keys;           /* Figures' keys, in report order */
+static std::map<std::string,Figures> figures;
+
+static Figures &figuresOf(const std::string &key)
+{
+    auto iter = figures.find(key);
+    if (iter == figures.end())
+    {
+        keys.push_back(key);
+        iter = figures.emplace(key, Figures()).first;
+    }
+    return iter->second;
+}
+
+/* Nearest rank percentile of v */
+static double percentile(std::vector<double> v, double pct)
+{
+    if (v.empty())
+        return 0;
+    std::sort(v.begin(), v.end());
+    int rank = int(std::ceil(pct / 100.0 * v.size())) - 1;
+    return v[std::max(rank, 0)];
+}
+
+/* Sends stdout, where dcc reports on the programs it reads, to /dev/null
+ * while decompiling; returns what to restore */
+static int quiet()
+{
+    fflush(stdout);
+#ifndef _WIN32
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    return saved;
+#else
+    return -1;
+#endif
+}
+
+static void unquiet(int saved)
+{
+    fflush(stdout);
+#ifndef _WIN32
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+#endif
+}
+
+/* name, relative to the directory dcc_phasebench was started in */
+static std::string fromStartDir(const char *name)
+{
+    if (name[0] == '/')
+        return name;
+    return QDir::currentPath().toStdString() + "/" + name;
+}
+
+static Summary summarize(const Figures &f)
+{
+    return Summary{percentile(f.wall, 50), percentile(f.wall, 90), percentile(f.cpu, 50),
+                   percentile(f.allocs, 50)};
+}
+
+/* Decompiles path on a project of its own, as a batch run does, and leaves
+ * the figures of each phase in res */
+static bool decompileOnce(const QString &path, PhaseSample (&res)[PH_COUNT])
+{
+    Project proj;
+    Project::setCurrent(&proj);
+    stats = STATS();
+    bool ok = true;
+    try
+    {
+        proj.create(path);
+        DccFrontend fe(nullptr);
+        if (proj.load() and fe.FrontEnd())
+        {
+            udm();
+            BackEnd(proj.callGraph);
+        }
+        else
+            ok = false;
+    }
+    catch (const FatalError &)
+    {
+        ok = false;
+    }
+    for (int ph = 0; ph < PH_COUNT; ph++)
+        res[ph] = Profiler::phaseTotal(proj, ePhase(ph));
+    QFile::remove(proj.output_name("b"));
+    Project::setCurrent(nullptr);
+    return ok;
+}
+
+static void save(const char *fname, int iterations)
+{
+    FILE *f = fopen(fname, "w");
+    if (f == nullptr)
+    {
+        fprintf(stderr, "dcc_phasebench: cannot write %s\n", fname);
+        return;
+    }
+    fprintf(f, "{\"iterations\": %d, \"results\": {\n", iterations);
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        Summary s = summarize(figures[keys[i]]);
+        fprintf(f, "  \"%s\": {\"wall_median\": %.4f, \"wall_p90\": %.4f, \"cpu_median\": %.4f, \"allocs_median\": %.0f}%s\n",
+                keys[i].c_str(), s.wallMedian, s.wallP90, s.cpuMedian, s.allocsMedian,
+                i + 1 < keys.size() ? "," : "");
+    }
+    fprintf(f, "}}\n");
+    fclose(f);
+}
+
+/* Reads a file written by save(), one result per line */
+static bool load(const char *fname, std::map<std::string,Summary> &res)
+{
+    FILE *f = fopen(fname, "r");
+    if (f == nullptr)
+    {
+        fprintf(stderr, "dcc_phasebench: cannot read %s\n", fname);
+        return false;
+    }
+    char line[512], key[256];
+    Summary s;
+    while (fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, " \"%255[^\"]\": {\"wall_median\": %lf, \"wall_p90\": %lf, \"cpu_median\": %lf, \"allocs_median\": %lf",
+                   key, &s.wallMedian, &s.wallP90, &s.cpuMedian, &s.allocsMedian) == 5)
+            res[key] = s;
+    }
+    fclose(f);
+    return true;
+}
+
+static double change(double now, double before)
+{
+    return before > 0 ? (now / before - 1.0) * 100.0 : 0;
+}
+
+static void usage()
+{
+    fprintf(stderr, "Usage: dcc_phasebench [-n iterations] [-j jobs] [--save file] [--baseline file]\n"
+                    "                      [--tolerance percent] [--min-time ms] [program.EXE...]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 10;
+    std::string saveName;
+    std::string baselineName;
+    double tolerance = 10;
+    double minTime = 1;
+    QStringList names;
+    option.Jobs = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (not strcmp(argv[i], "-n") and hasValue)
+            iterations = std::max(atoi(argv[++i]), 1);
+        else if (not strcmp(argv[i], "-j") and hasValue)
+            option.Jobs = unsigned(std::max(atoi(argv[++i]), 1));
+        else if (not strcmp(argv[i], "--save") and hasValue)
+            saveName = fromStartDir(argv[++i]);
+        else if (not strcmp(argv[i], "--baseline") and hasValue)
+            baselineName = fromStartDir(argv[++i]);
+        else if (not strcmp(argv[i], "--tolerance") and hasValue)
+            tolerance = atof(argv[++i]);
+        else if (not strcmp(argv[i], "--min-time") and hasValue)
+            minTime = atof(argv[++i]);
+        else if (argv[i][0] == '-')
+            usage();
+        else
+            names << argv[i];
+    }
+
+    /* As decompiling a batch with -c: an error gives up the program only */
+    option.Calls = true;
+    option.Batch = true;
+    Profiler::enable();
+
+    /* Signature files are looked up relative to the working directory */
+    QDir::setCurrent(DCC_SOURCE_DIR);
+    QDir corpus(QString(DCC_SOURCE_DIR) + "/tests/inputs_base");
+    if (names.empty())
+        names = corpus.entryList(QStringList() << "*.EXE", QDir::Files);
+
+    /* The first run of each program loads the signature files; it is not timed */
+    int savedStdout = quiet();
+    int numNames = int(names.size());
+    std::vector<bool> failed(numNames, false);
+    for (int p = 0; p < numNames; p++)
+    {
+        PhaseSample res[PH_COUNT];
+        failed[p] = not decompileOnce(corpus.absoluteFilePath(names[p]), res);
+        if (failed[p])
+            fprintf(stderr, "dcc_phasebench: %s fails, left out\n", qPrintable(names[p]));
+    }
+    for (int it = 0; it < iterations; it++)
+    {
+        PhaseSample total[PH_COUNT];
+        for (int p = 0; p < numNames; p++)
+        {
+            if (failed[p])
+                continue;
+            PhaseSample res[PH_COUNT];
+            decompileOnce(corpus.absoluteFilePath(names[p]), res);
+            for (int ph = 0; ph < PH_COUNT; ph++)
+            {
+                Figures &f(figuresOf(names[p].toStdString() + "/" + Profiler::phaseName(ePhase(ph))));
+                f.wall.push_back(res[ph].wall * 1000);
+                f.cpu.push_back(res[ph].cpu * 1000);
+                f.allocs.push_back(double(res[ph].allocs));
+                total[ph].add(res[ph]);
+            }
+        }
+        for (int ph = 0; ph < PH_COUNT; ph++)
+        {
+            Figures &f(figuresOf(std::string("total/") + Profiler::phaseName(ePhase(ph))));
+            f.wall.push_back(total[ph].wall * 1000);
+            f.cpu.push_back(total[ph].cpu * 1000);
+            f.allocs.push_back(double(total[ph].allocs));
+        }
+    }
+
+    unquiet(savedStdout);
+
+    std::map<std::string,Summary> baseline;
+    if (not baselineName.empty() and not load(baselineName.c_str(), baseline))
+        return 2;
+    printf("%d iterations, %u jobs; times in ms\n", iterations, option.Jobs);
+    printf("%-34s %9s %9s %9s %9s %9s %10s %9s\n", "program/phase", "wall p50", "wall p90", "wall p99",
+           "wall max", "cpu p50", "allocs p50", baselineName.empty() ? "" : "vs base");
+    int regressions = 0;
+    for (const std::string &key : keys)
+    {
+        const Figures &f(figures[key]);
+        Summary s = summarize(f);
+        printf("%-34s %9.3f %9.3f %9.3f %9.3f %9.3f %10.0f", key.c_str(), s.wallMedian, s.wallP90,
+               percentile(f.wall, 99), percentile(f.wall, 100), s.cpuMedian, s.allocsMedian);
+        auto iter = baseline.find(key);
+        if (iter != baseline.end())
+        {
+            const Summary &b(iter->second);
+            printf(" %+8.1f%%", change(s.wallMedian, b.wallMedian));
+            bool slower = b.wallMedian >= minTime and change(s.wallMedian, b.wallMedian) > tolerance;
+            bool bigger = change(s.allocsMedian, b.allocsMedian) > tolerance;
+            if (slower or bigger)
+            {
+                printf("  REGRESSION%s%s", slower ? " time" : "", bigger ? " allocs" : "");
+                regressions++;
+            }
+        }
+        printf("\n");
+    }
+    if (not saveName.empty())
+        save(saveName.c_str(), iterations);
+    if (not baselineName.empty())
+        printf("%d regressions against %s\n", regressions, baselineName.c_str());
+    return regressions ? 1 : 0;
+}
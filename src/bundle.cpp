@@ -1,94 +1,152 @@
 /*****************************************************************************
  * File: bundle.c
- * Module that handles the bundle type (array of pointers to strings).
+ * Module that handles the bundle type (the declarations and code of the
+ * procedure being generated).
  * (C) Cristina Cifuentes
  ****************************************************************************/
 
 #include "dcc.h"
+#include "project.h"
+
+#include <algorithm>
 #include <stdarg.h>
-#include <iostream>
-#include <memory.h>
 #include <stdlib.h>
 #include <string.h>
+#include <memory>
 #include <QtCore/QIODevice>
-#define deltaProcLines  20
+#define lineSize	360		/* Lines longer than this are formatted twice */
 
 using namespace std;
-/* Allocates memory for a new bundle and initializes it to zero.    */
-
 
-/* Adds the given label to the start of the line strTab[idx].  The first
- * tab is removed and replaced by this label */
-void strTable::addLabelBundle (int idx, int label)
+void LineBuffer::append(const char *s, size_t len)
 {
-    QString &processedLine(at(idx));
-    QString s = QString("l%1: ").arg(label);
-    if(processedLine.size()<4)
-        processedLine = s;
-    else
-        processedLine = s+processedLine.mid(4);
+    m_starts.push_back(uint32_t(m_text.size()));
+    m_text.append(s, len);
 }
 
+void LineBuffer::append(const QString &s)
+{
+    const QByteArray bytes(s.toLatin1());
+    append(bytes.constData(), size_t(bytes.size()));
+}
 
-/* Writes the contents of the string table on the file fp.  */
-static void writeStrTab (QIODevice &ios, strTable &strTab)
+void LineBuffer::appendWithLabel(const char *before, int label, const char *after)
 {
-    for (size_t i = 0; i < strTab.size(); i++)
-        ios.write(strTab[i].toLatin1());
+    m_starts.push_back(uint32_t(m_text.size()));
+    m_text.append(before);
+    m_labels.push_back(LabelRef{uint32_t(m_text.size()), label});
+    m_text.append(after);
 }
 
+/* Adds the given label to the start of the line idx.  When written, the
+ * first tab is removed and replaced by this label */
+void LineBuffer::addLabelBundle (int idx, int label)
+{
+    m_lineLabels.push_back(LineLabel{uint32_t(idx), label});
+}
 
-/* Writes the contents of the bundle (procedure code and declaration) to
- * a file.          */
-void writeBundle (QIODevice &ios, bundle procCode)
+/* Writes the text, with the label numbers after labelBase written in, and
+ * the first tab of each labelled line, with any label number in it,
+ * replaced by "lN: " */
+void LineBuffer::write(QIODevice &ios, int labelBase) const
 {
-    writeStrTab (ios, procCode.decl);
-    writeStrTab (ios, procCode.code);
+    std::vector<LineLabel> lines(m_lineLabels);
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const LineLabel &a, const LineLabel &b) { return a.line < b.line; });
+    char num[16];
+    uint32_t done = 0;
+    auto ref = m_labels.begin();
+    /* Writes the text, with its label numbers, up to offset off */
+    auto writeRefs = [&](uint32_t off) {
+        for (; ref != m_labels.end() and ref->off < off; ++ref)
+        {
+            int len = sprintf(num, "%d", labelBase + ref->label);
+            ios.write(m_text.data() + done, qint64(ref->off - done));
+            ios.write(num, len);
+            done = ref->off;
+        }
+    };
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        if (i+1 < lines.size() and lines[i+1].line == lines[i].line)
+            continue;                   /* The latest label of a line wins */
+        uint32_t idx = lines[i].line;
+        uint32_t start = m_starts[idx];
+        uint32_t end = (size_t(idx)+1 < m_starts.size()) ? m_starts[idx+1] : uint32_t(m_text.size());
+        uint32_t replaced = (end-start < 4) ? end-start : 4;
+        writeRefs(start);
+        while (ref != m_labels.end() and ref->off < start + replaced)
+            ++ref;
+        int len = sprintf(num, "l%d: ", labelBase + lines[i].label);
+        ios.write(m_text.data() + done, qint64(start - done));
+        ios.write(num, len);
+        done = start + replaced;
+    }
+    writeRefs(uint32_t(m_text.size()) + 1);
+    ios.write(m_text.data() + done, qint64(m_text.size() - done));
 }
 
 
-/* Frees the storage allocated by the string table. */
-static void freeStrTab (strTable &strTab)
+/* Writes the contents of the bundle (procedure header, declarations and
+ * code) to a file, and empties it. */
+void writeBundle (QIODevice &ios, bundle &procCode)
 {
-    strTab.clear();
+    int &labelIdx(Project::get()->labelIdx);
+    procCode.head.write(ios, labelIdx);
+    procCode.decl.write(ios, labelIdx);
+    procCode.code.write(ios, labelIdx);
+    labelIdx += procCode.labels;
+    procCode.init();
 }
 
-
-/* Deallocates the space taken by the bundle procCode */
-void freeBundle (bundle *procCode)
+/* Formats one line into buf.  Text that is not plain ASCII is converted as
+ * the QString it used to be made into. */
+static void appendFormatted (LineBuffer &buf, const char *format, va_list args)
 {
-    freeStrTab (procCode->decl);
-    freeStrTab (procCode->code);
+    char line[lineSize];
+    va_list again;
+    va_copy (again, args);
+    int len = vsnprintf (line, lineSize, format, args);
+    std::unique_ptr<char[]> longLine;
+    char *text = line;
+    if (len >= lineSize)
+    {
+        longLine.reset(new char[len+1]);
+        vsnprintf (longLine.get(), len+1, format, again);
+        text = longLine.get();
+    }
+    va_end (again);
+    len = int(strlen(text));    /* A QString stopped at the first null */
+    for (int i = 0; i < len; i++)
+        if (uint8_t(text[i]) >= 0x80)
+        {
+            buf.append(QString::fromUtf8(text, len));
+            return;
+        }
+    buf.append(text, len);
 }
 
 void bundle::appendCode(const char *format,...)
 {
     va_list args;
-    char buf[lineSize]={0};
     va_start (args, format);
-    vsprintf (buf, format, args);
-    code.push_back(buf);
+    appendFormatted (code, format, args);
     va_end (args);
 }
 void bundle::appendCode(const QString & s)
 {
-    code.push_back(s);
+    code.append(s);
 }
 
 void bundle::appendDecl(const char *format,...)
 {
     va_list args;
-    char buf[lineSize]={0};
     va_start (args, format);
-    vsprintf (buf, format, args);
-    decl.push_back(buf);
+    appendFormatted (decl, format, args);
     va_end (args);
 }
 
 void bundle::appendDecl(const QString &v)
 {
-    decl.push_back(v);
+    decl.append(v);
 }
-
-
-
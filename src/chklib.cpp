@@ -8,7 +8,7 @@
 #include "dcc.h"
 #include "msvc_fixes.h"
 #include "project.h"
-#include "perfhlib.h"
+#include "SigFile.h"
 #include "dcc_interface.h"
 
 #include <QtCore/QDir>
@@ -18,61 +18,34 @@
 #include <stdlib.h>
 #include <memory.h>
 #include <string.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
-PerfectHash g_pattern_hasher;
 #define  NIL   -1                   /* Used like NULL, but 0 is valid */
 
-/* Hash table structure */
-typedef struct HT_tag
-{
-    char    htSym[SYMLEN];
-    uint8_t    htPat[PATLEN];
-} HT;
-
-/* Structure of the prototypes table. Same as the struct in parsehdr.h,
-    except here we don't need the "next" index (the elements are already
-    sorted by function name) */
-typedef
-struct ph_func_tag
-{
-    char    name[SYMLEN];               /* Name of function or arg */
-    hlType  typ;                        /* Return type */
-    int     numArg;                     /* Number of args */
-    int     firstArg;                   /* Index of first arg in chain */
-    //  int     next;                       /* Index of next function in chain */
-    bool    bVararg;                    /* True if variable arguements */
-} PH_FUNC_STRUCT;
-
+static_assert(SIGFILE_SYMLEN == SYMLEN and SIGFILE_PATLEN == PATLEN,
+              "signature file and dcc disagree on the symbol and pattern lengths");
 
 #define NUM_PLIST   64              	/* Number of entries to increase allocation by */
 
 /* statics */
-static char buf[100];          				/* A general purpose buffer */
-int numKeys;            				/* Number of hash table entries (keys) */
-int numVert;            				/* Number of vertices in the graph (also size of g[]) */
-unsigned PatLen;        				/* Size of the keys (pattern length) */
-unsigned SymLen;        				/* Max size of the symbols, including null */
-static FILE *g_file;                				/* File being read */
-static QString sSigName; 			/* Full path name of .sig file */
-
-static  uint16_t    *T1base, *T2base;       /* Pointers to start of T1, T2 */
-static  uint16_t    *g;                     /* g[] */
-static  HT      *ht;                    /* The hash table */
-static  PH_FUNC_STRUCT *pFunc;          /* Points to the array of func names */
-static  hlType  *pArg=nullptr;                /* Points to the array of param types */
-static  int     numFunc;                /* Number of func names actually stored */
-static  int     numArg;                 /* Number of param names actually stored */
+static thread_local QString sSigName; 	/* Full path name of .sig file */
+
+/* Signature files and the prototypes are mapped the first time a program
+   needs them, and then shared read only by all the programs being decompiled */
+static  std::mutex  libMutex;           /* Held while loading the files */
+static  std::map<QString,std::unique_ptr<SigFile> > loadedSigs; /* nullptr if unusable */
+static  bool    protosLoaded = false;   /* readProtoFile() was called */
+static thread_local const SigFile *curSigs; /* Signatures of the program being parsed */
+static  ProtoFile protos;               /* Library function prototypes */
 #define DCCLIBS "dcclibs.dat"           /* Name of the prototypes data file */
 
 /* prototypes */
-void grab(int n, FILE *_file);
-uint16_t readFileShort(FILE *_file);
-void readFileSection(uint16_t* p, int len, FILE *_file);
-void cleanup(void);
 void checkStartup(STATE *state);
 void readProtoFile(void);
-int  searchPList(char *name);
-void checkHeap(char *msg);              /* For debugging */
+int  searchPList(const char *name);
 
 void fixWildCards(uint8_t pat[]);			/* In fixwild.c */
 
@@ -297,138 +270,38 @@ static uint8_t pattMsChkstk[] =
 
 
 
+/* Loads the signature file fpath, or returns nullptr if it cannot be used */
+static SigFile *readSigFile(const QString &fpath)
+{
+    if (not protosLoaded)
+    {
+        readProtoFile();
+        protosLoaded = true;
+    }
+    std::unique_ptr<SigFile> sigs(new SigFile);
+    if (not sigs->load(qPrintable(fpath)))
+        return nullptr;
+    return sigs.release();
+}
+
 /* This procedure is called to initialise the library check code */
 bool SetupLibCheck(void)
 {
-    uint16_t w, len;
-    int i;
     IDcc *dcc = IDcc::get();
     QString fpath = dcc->dataDir("sigs").absoluteFilePath(sSigName);
-    if ((g_file = fopen(qPrintable(fpath), "rb")) == nullptr)
-    {
-        printf("Warning: cannot open signature file %s\n", qPrintable(fpath));
-        return false;
-    }
-
-    readProtoFile();
-
-
-    /* Read the parameters */
-    grab(4, g_file);
-    if (memcmp("dccs", buf, 4) != 0)
-    {
-        printf("Not a dcc signature file!\n");
-        exit(3);
-    }
-    numKeys = readFileShort(g_file);
-    numVert = readFileShort(g_file);
-    PatLen = readFileShort(g_file);
-    SymLen = readFileShort(g_file);
-    if ((PatLen != PATLEN) or (SymLen != SYMLEN))
-    {
-        printf("Sorry! Compiled for sym and pattern lengths of %d and %d\n", SYMLEN, PATLEN);
-        return false;
-    }
-
-    /* Initialise the perfhlib stuff. Also allocates T1, T2, g, etc */
-    /* Set the parameters for the hash table */
-    g_pattern_hasher.setHashParams(
-                    numKeys,                /* The number of symbols */
-                    PatLen,                 /* The length of the pattern to be hashed */
-                    256,                    /* The character set of the pattern (0-FF) */
-                    0,                      /* Minimum pattern character value */
-                    numVert);               /* Specifies c, the sparseness of the graph. See Czech, Havas and Majewski for details */
-    T1base  = g_pattern_hasher.readT1();
-    T2base  = g_pattern_hasher.readT2();
-    g       = g_pattern_hasher.readG();
-
-    /* Read T1 and T2 tables */
-    grab(2, g_file);
-    if (memcmp("T1", buf, 2) != 0)
-    {
-        printf("Expected 'T1'\n");
-        exit(3);
-    }
-    len = (uint16_t) (PatLen * 256 * sizeof(uint16_t));
-    w = readFileShort(g_file);
-    if (w != len)
-    {
-        printf("Problem with size of T1: file %d, calc %d\n", w, len);
-        return false;
-    }
-    readFileSection(T1base, len, g_file);
-
-    grab(2, g_file);
-    if (memcmp("T2", buf, 2) != 0)
-    {
-        printf("Expected 'T2'\n");
-        return false;
-    }
-    w = readFileShort(g_file);
-    if (w != len)
-    {
-        printf("Problem with size of T2: file %d, calc %d\n", w, len);
-        return false;
-    }
-    readFileSection(T2base, len, g_file);
-
-    /* Now read the function g[] */
-    grab(2, g_file);
-    if (memcmp("gg", buf, 2) != 0)
-    {
-        printf("Expected 'gg'\n");
-        return false;
-    }
-    len = (uint16_t)(numVert * sizeof(uint16_t));
-    w = readFileShort(g_file);
-    if (w != len)
-    {
-        printf("Problem with size of g[]: file %d, calc %d\n", w, len);
-        return false;
-    }
-    readFileSection(g, len, g_file);
-
-
-    /* This is now the hash table */
-    /* First allocate space for the table */
-    ht = new HT[numKeys];
-    if ( nullptr == ht)
-    {
-        printf("Could not allocate hash table\n");
-        return false;
-    }
-    grab(2, g_file);
-    if (memcmp("ht", buf, 2) != 0)
-    {
-        printf("Expected 'ht'\n");
-        return false;
-    }
-    w = readFileShort(g_file);
-    if (w != numKeys * (SymLen + PatLen + sizeof(uint16_t)))
-    {
-        printf("Problem with size of hash table: file %d, calc %d\n", w, len);
-        return false;
-    }
-
-
-    for (i=0; i < numKeys; i++)
-    {
-        if (fread(&ht[i], 1, SymLen + PatLen, g_file) != SymLen + PatLen)
-        {
-            printf("Could not read signature\n");
-            return false;
-        }
-    }
-    fclose(g_file);
-    return true;
+    std::lock_guard<std::mutex> lock(libMutex);
+    auto iter = loadedSigs.find(fpath);
+    if (iter == loadedSigs.end())
+        iter = loadedSigs.emplace(fpath, std::unique_ptr<SigFile>(readSigFile(fpath))).first;
+    curSigs = iter->second.get();
+    return curSigs != nullptr;
 }
 
 
 void CleanupLibCheck(void)
 {
-    /* Deallocate all the stuff allocated in SetupLibCheck() */
-    delete [] ht;
-    delete [] pFunc;
+    /* The tables stay loaded for the next program that uses them */
+    curSigs = nullptr;
 }
 
 
@@ -462,19 +335,20 @@ bool LibCheck(Function & pProc)
     memcpy(pat, &prog.image()[fileOffset], PATLEN);
     //memmove(pat, &prog.image()[fileOffset], PATLEN);
     fixWildCards(pat);                  /* Fix wild cards in the copy */
-    h = g_pattern_hasher.hash(pat);                      /* Hash the found proc */
+    h = curSigs->hasher.hash(pat);                      /* Hash the found proc */
+    const SigFileEntry &entry(curSigs->ht[h]);
     /* We always have to compare keys, because the hash function will always return a valid index */
-    if (memcmp(ht[h].htPat, pat, PATLEN) == 0)
+    if (memcmp(entry.pat, pat, PATLEN) == 0)
     {
         /* We have a match. Save the name, if not already set */
         if (pProc.name.isEmpty() )     /* Don't overwrite existing name */
         {
             /* Give proc the new name */
-            pProc.name = ht[h].htSym;
+            pProc.name = entry.sym;
         }
         /* But is it a real library function? */
         i = NIL;
-        if ((numFunc == 0) or (i=searchPList(ht[h].htSym)) != NIL)
+        if ((protos.numFunc == 0) or (i=searchPList(entry.sym)) != NIL)
         {
             pProc.flg |= PROC_ISLIB; 		/* It's a lib function */
             pProc.callingConv(CConv::eCdecl);
@@ -482,16 +356,17 @@ bool LibCheck(Function & pProc)
             {
                 /* Allocate space for the arg struct, and copy the hlType to
                     the appropriate field */
-                arg = pFunc[i].firstArg;
-                pProc.args.numArgs = pFunc[i].numArg;
-                pProc.args.resize(pFunc[i].numArg);
-                for (j=0; j < pFunc[i].numArg; j++)
+                const ProtoFileFunc &proto(protos.func[i]);
+                arg = proto.firstArg;
+                pProc.args.numArgs = proto.numArg;
+                pProc.args.resize(proto.numArg);
+                for (j=0; j < proto.numArg; j++)
                 {
-                    pProc.args[j].type = pArg[arg++];
+                    pProc.args[j].type = (hlType)protos.arg[arg++];
                 }
-                if (pFunc[i].typ != TYPE_UNKNOWN)
+                if (proto.typ != TYPE_UNKNOWN)
                 {
-                    pProc.retVal.type = pFunc[i].typ;
+                    pProc.retVal.type = (hlType)proto.typ;
                     pProc.flg |= PROC_IS_FUNC;
                     switch (pProc.retVal.type) {
                         case TYPE_LONG_SIGN: case TYPE_LONG_UNSIGN:
@@ -514,7 +389,7 @@ bool LibCheck(Function & pProc)
                             /*** other types are not considered yet ***/
                     }
                 }
-                pProc.getFunctionType()->m_vararg = pFunc[i].bVararg;
+                pProc.getFunctionType()->m_vararg = proto.bVararg;
             }
         }
         else if (i == NIL)
@@ -539,52 +414,6 @@ bool LibCheck(Function & pProc)
 
 
 
-void grab(int n, FILE *_file)
-{
-    if (fread(buf, 1, n, _file) != (unsigned)n)
-    {
-        printf("Could not grab\n");
-        exit(11);
-    }
-}
-
-uint16_t readFileShort(FILE *f)
-{
-    uint8_t b1, b2;
-
-    if (fread(&b1, 1, 1, f) != 1)
-    {
-        printf("Could not read short\n");
-        exit(11);
-    }
-    if (fread(&b2, 1, 1, f) != 1)
-    {
-        printf("Could not read short\n");
-        exit(11);
-    }
-    return (uint16_t)(b2 << 8) + (uint16_t)b1;
-}
-
-// Read a section of the file, considering endian issues
-void readFileSection(uint16_t* p, int len, FILE* f)
-{
-    for (int i=0; i < len; i += 2)
-    {
-        *p++ = readFileShort(f);
-    }
-}
-
-/* The following two functions are dummies, since we don't call map() */
-void getKey(int /*i*/, uint8_t **/*keys*/)
-{
-
-}
-
-void dispKey(int /*i*/)
-{
-
-}
-
 /* Search the source array between limits iMin and iMax for the pattern (length
     iPatLen). The pattern can contain wild bytes; if you really want to match
     for the pattern that is used up by the WILD uint8_t, tough - it will match with
@@ -850,87 +679,23 @@ void readProtoFile(void)
 {
     IDcc *dcc = IDcc::get();
     QString szProFName = dcc->dataDir("prototypes").absoluteFilePath(DCCLIBS); /* Full name of dclibs.lst */
-
-    FILE *fProto;
-    int  i;
-
-    if ((fProto = fopen(qPrintable(szProFName), "rb")) == nullptr)
-    {
-        printf("Warning: cannot open library prototype data file %s\n", qPrintable(szProFName));
-        return;
-    }
-
-    grab(4, fProto);
-    if (strncmp(buf, "dccp", 4) != 0)
-    {
-        printf("%s is not a dcc prototype file\n", qPrintable(szProFName));
-        exit(1);
-    }
-
-    grab(2, fProto);
-    if (strncmp(buf, "FN", 2) != 0)
-    {
-        printf("FN (Function Name) subsection expected in %s\n", qPrintable(szProFName));
-        exit(2);
-    }
-
-    numFunc = readFileShort(fProto);     /* Num of entries to allocate */
-
-    /* Allocate exactly correct # entries */
-    pFunc = new PH_FUNC_STRUCT[numFunc];
-
-    for (i=0; i < numFunc; i++)
-    {
-        size_t read_size=fread(&pFunc[i], 1, SYMLEN, fProto);
-        assert(read_size==SYMLEN);
-        if(read_size!=SYMLEN)
-            break;
-        pFunc[i].typ      = (hlType)readFileShort(fProto);
-        pFunc[i].numArg   = readFileShort(fProto);
-        pFunc[i].firstArg = readFileShort(fProto);
-        if(feof(fProto))
-            break;
-        int c = fgetc(fProto);
-        pFunc[i].bVararg = (c!=0); //fread(&pFunc[i].bVararg, 1, 1, fProto);
-    }
-
-    grab(2, fProto);
-    if (strncmp(buf, "PM", 2) != 0)
-    {
-        printf("PM (Parameter) subsection expected in %s\n", qPrintable(szProFName));
-        exit(2);
-    }
-
-    numArg = readFileShort(fProto);     /* Num of entries to allocate */
-
-    /* Allocate exactly correct # entries */
-    delete [] pArg;
-    pArg = new hlType[numArg];
-
-    for (i=0; i < numArg; i++)
-    {
-        //      fread(&pArg[i], 1, SYMLEN, fProto);     /* No names to read as yet */
-        pArg[i] = (hlType) readFileShort(fProto);
-    }
-
-    fclose(fProto);
-
+    protos.load(qPrintable(szProFName));
 }
 
-int searchPList(char *name)
+int searchPList(const char *name)
 {
     /* Search through the symbol names for the name */
     /* Use binary search */
     int mx, mn, i, res;
 
 
-    mx = numFunc;
+    mx = protos.numFunc;
     mn = 0;
 
     while (mn < mx)
     {
         i = (mn + mx) /2;
-        res = strcmp(pFunc[i].name, name);
+        res = strcmp(protos.func[i].name, name);
         if (res == 0)
         {
             return i;            /* Found! */
@@ -949,7 +714,11 @@ int searchPList(char *name)
     }
 
     /* Still could be the case that mn == mx == required record */
-    res = strcmp(pFunc[mn].name, name);
+    if (mn < 0 or mn >= int(protos.numFunc))
+    {
+        return NIL;
+    }
+    res = strcmp(protos.func[mn].name, name);
     if (res == 0)
     {
         return mn;            /* Found! */
@@ -5,6 +5,7 @@
 
 #include "dcc.h"
 #include "msvc_fixes.h"
+#include "NodeSet.h"
 
 #include <boost/range/algorithm.hpp>
 #include <cassert>
@@ -40,45 +41,20 @@ bool isBackEdge (BB * p,BB * s)
 }
 
 
-/** Finds the common dominator of the current immediate dominator
- * currImmDom and its predecessor's immediate dominator predImmDom  */
-int commonDom (int currImmDom, int predImmDom, Function * pProc)
+/* Returns whether the node n belongs to the interval's nodes q. */
+bool inInt(BB * n, const NodeSet &q)
 {
-    if (currImmDom == NO_DOM)
-        return (predImmDom);
-    if (predImmDom == NO_DOM)   /* predecessor is the root */
-        return (currImmDom);
-
-    while ((currImmDom != NO_DOM) and (predImmDom != NO_DOM) and
-           (currImmDom != predImmDom))
-    {
-        if (currImmDom < predImmDom)
-            predImmDom = pProc->m_dfsLast[predImmDom]->immedDom;
-        else
-            currImmDom = pProc->m_dfsLast[currImmDom]->immedDom;
-    }
-    return (currImmDom);
-}
-/* Returns whether or not the node n (dfsLast numbering of a basic block)
- * is on the list l. */
-bool inList (const nodeList &l, int n)
-{
-    return std::find(l.begin(),l.end(),n)!=l.end();
-}
-/* Returns whether the node n belongs to the queue list q. */
-bool inInt(BB * n, queue &q)
-{
-    return std::find(q.begin(),q.end(),n)!=q.end();
+    return q.contains(n->dfsLastNum);
 }
 /** Recursive procedure to find nodes that belong to the interval (ie. nodes
  * from G1).                                */
-void findNodesInInt (queue &intNodes, int level, interval *Ii)
+void findNodesInInt (NodeSet &intNodes, int level, interval *Ii)
 {
     if (level == 1)
     {
         for(BB *en : Ii->nodes)
         {
-            appendQueue(intNodes,en);
+            intNodes.insert(en->dfsLastNum);
         }
     }
     else
@@ -91,7 +67,7 @@ void findNodesInInt (queue &intNodes, int level, interval *Ii)
 }
 /* Finds the follow of the endless loop headed at node head (if any).
  * The follow node is the closest node to the loop. */
-void findEndlessFollow (Function * pProc, nodeList &loopNodes, BB * head)
+void findEndlessFollow (Function * pProc, const NodeSet &loopNodes, BB * head)
 {
     head->loopFollow = MAX;
     for( int loop_node :  loopNodes)
@@ -99,7 +75,7 @@ void findEndlessFollow (Function * pProc, nodeList &loopNodes, BB * head)
         for (const TYPEADR_TYPE &typeaddr: pProc->m_dfsLast[loop_node]->edges)
         {
             int succ = typeaddr.BBptr->dfsLastNum;
-            if ((not inList(loopNodes, succ)) and (succ < head->loopFollow))
+            if ((not loopNodes.contains(succ)) and (succ < head->loopFollow))
                 head->loopFollow = succ;
         }
     }
@@ -109,42 +85,41 @@ void findEndlessFollow (Function * pProc, nodeList &loopNodes, BB * head)
 //static void findNodesInLoop(BB * latchNode,BB * head,PPROC pProc,queue *intNodes)
 /* Flags nodes that belong to the loop determined by (latchNode, head) and
  * determines the type of loop.                     */
-void findNodesInLoop(BB * latchNode,BB * head,Function * pProc,queue &intNodes)
+void findNodesInLoop(BB * latchNode,BB * head,Function * pProc,const NodeSet &intNodes)
 {
     int i, headDfsNum, intNodeType;
-    nodeList loopNodes;
+    NodeSet loopNodes(pProc->numBBs);
     int immedDom,     		/* dfsLast index to immediate dominator */
         thenDfs, elseDfs;       /* dsfLast index for THEN and ELSE nodes */
-    BB * pbb;
 
     /* Flag nodes in loop headed by head (except header node) */
     headDfsNum = head->dfsLastNum;
     head->loopHead = headDfsNum;
-    loopNodes.push_back(headDfsNum);
+    loopNodes.insert(headDfsNum);
     for (i = headDfsNum + 1; i < latchNode->dfsLastNum; i++)
     {
         if (pProc->m_dfsLast[i]->flg & INVALID_BB)	/* skip invalid BBs */
             continue;
 
         immedDom = pProc->m_dfsLast[i]->immedDom;
-        if (inList (loopNodes, immedDom) and inInt(pProc->m_dfsLast[i], intNodes))
+        if (loopNodes.contains(immedDom) and inInt(pProc->m_dfsLast[i], intNodes))
         {
-            loopNodes.push_back(i);
+            loopNodes.insert(i);
             if (pProc->m_dfsLast[i]->loopHead == NO_NODE)/*not in other loop*/
                 pProc->m_dfsLast[i]->loopHead = headDfsNum;
         }
     }
     latchNode->loopHead = headDfsNum;
     if (latchNode != head)
-        loopNodes.push_back(latchNode->dfsLastNum);
+        loopNodes.insert(latchNode->dfsLastNum);
 
     /* Determine type of loop and follow node */
     intNodeType = head->nodeType;
     if (latchNode->nodeType == TWO_BRANCH)
         if ((intNodeType == TWO_BRANCH) or (latchNode == head))
             if ((latchNode == head) or
-                (inList (loopNodes, head->edges[THEN].BBptr->dfsLastNum) and
-                 inList (loopNodes, head->edges[ELSE].BBptr->dfsLastNum)))
+                (loopNodes.contains(head->edges[THEN].BBptr->dfsLastNum) and
+                 loopNodes.contains(head->edges[ELSE].BBptr->dfsLastNum)))
             {
                 head->loopType = eNodeHeaderType::REPEAT_TYPE;
                 if (latchNode->edges[0].BBptr == head)
@@ -156,7 +131,7 @@ void findNodesInLoop(BB * latchNode,BB * head,Function * pProc,queue &intNodes)
             else
             {
                 head->loopType = eNodeHeaderType::WHILE_TYPE;
-                if (inList (loopNodes, head->edges[THEN].BBptr->dfsLastNum))
+                if (loopNodes.contains(head->edges[THEN].BBptr->dfsLastNum))
                     head->loopFollow = head->edges[ELSE].BBptr->dfsLastNum;
                 else
                     head->loopFollow = head->edges[THEN].BBptr->dfsLastNum;
@@ -180,33 +155,28 @@ void findNodesInLoop(BB * latchNode,BB * head,Function * pProc,queue &intNodes)
         else if (intNodeType == TWO_BRANCH)
         {
             head->loopType = eNodeHeaderType::WHILE_TYPE;
-            pbb = latchNode;
             thenDfs = head->edges[THEN].BBptr->dfsLastNum;
             elseDfs = head->edges[ELSE].BBptr->dfsLastNum;
-            while (1)
-            {
-                if (pbb->dfsLastNum == thenDfs)
-                {
-                    head->loopFollow = elseDfs;
-                    break;
-                }
-                else if (pbb->dfsLastNum == elseDfs)
-                {
-                    head->loopFollow = thenDfs;
-                    break;
-                }
 
-                /* Check if couldn't find it, then it is a strangely formed
-                 * loop, so it is safer to consider it an endless loop */
-                if (pbb->dfsLastNum <= head->dfsLastNum)
-                {
-                    head->loopType = eNodeHeaderType::ENDLESS_TYPE;
-                    findEndlessFollow (pProc, loopNodes, head);
-                    break;
-                }
-                pbb = pProc->m_dfsLast[pbb->immedDom];
+            /* The follow is the branch that does not lead to the latching
+             * node: the one of then and else that dominates the latching
+             * node, and is nearest to it, decides.  If neither does it is a
+             * strangely formed loop, so it is safer to consider it an
+             * endless loop */
+            const DominatorTree &domTree(pProc->m_domTree);
+            int latchDfs = latchNode->dfsLastNum;
+            bool thenDom = (thenDfs >= headDfsNum) and domTree.dominates(thenDfs, latchDfs);
+            bool elseDom = (elseDfs >= headDfsNum) and domTree.dominates(elseDfs, latchDfs);
+            if (thenDom and ((not elseDom) or (thenDfs >= elseDfs)))
+                head->loopFollow = elseDfs;
+            else if (elseDom)
+                head->loopFollow = thenDfs;
+            else
+            {
+                head->loopType = eNodeHeaderType::ENDLESS_TYPE;
+                findEndlessFollow (pProc, loopNodes, head);
             }
-            if (pbb->dfsLastNum > head->dfsLastNum)
+            if ((thenDom and (thenDfs > headDfsNum)) or (elseDom and (elseDfs > headDfsNum)))
                 pProc->m_dfsLast[head->loopFollow]->loopHead = NO_NODE;	/*****/
             head->back().ll()->setFlags(JX_LOOP);
         }
@@ -234,15 +204,15 @@ bool successor (int s, int h, Function * pProc)
 /** Recursive procedure to tag nodes that belong to the case described by
  * the list l, head and tail (dfsLast index to first and exit node of the
  * case).                               */
-void tagNodesInCase (BB * pBB, nodeList &l, int head, int tail)
+void tagNodesInCase (BB * pBB, NodeSet &l, int head, int tail)
 {
     int current;      /* index to current node */
 
     pBB->traversed = DFS_CASE;
     current = pBB->dfsLastNum;
-    if ((current != tail) and (pBB->nodeType != MULTI_BRANCH) and (inList (l, pBB->immedDom)))
+    if ((current != tail) and (pBB->nodeType != MULTI_BRANCH) and (l.contains(pBB->immedDom)))
     {
-        l.push_back(current);
+        l.insert(current);
         pBB->caseHead = head;
         for(TYPEADR_TYPE &edge : pBB->edges)
         {
@@ -268,23 +238,11 @@ void flagNodes (nodeList &l, int f, Function * pProc)
 
 /** Finds the immediate dominator of each node in the graph pProc->cfg.
  * Adapted version of the dominators algorithm by Hecht and Ullman; finds
- * immediate dominators only.
+ * immediate dominators only, and keeps the dominator tree they form.
  * Note: graph should be reducible */
 void Function::findImmedDom ()
 {
-    BB * currNode;
-    for (size_t currIdx = 0; currIdx < numBBs; currIdx++)
-    {
-        currNode = m_dfsLast[currIdx];
-        if (currNode->flg & INVALID_BB)		/* Do not process invalid BBs */
-            continue;
-        for (BB * inedge : currNode->inEdges)
-        {
-            size_t predIdx = inedge->dfsLastNum;
-            if (predIdx < currIdx)
-                currNode->immedDom = commonDom (currNode->immedDom, predIdx, this);
-        }
-    }
+    m_domTree.build(*this);
 }
 
 
@@ -297,7 +255,7 @@ void Function::structLoops(derSeq *derivedG)
             * latchNode;/* latching node (in case of loops) */
     size_t  level = 0;  /* derived sequence level       	*/
     interval *initInt;  /* initial interval         		*/
-    queue intNodes;  	/* list of interval nodes       	*/
+    NodeSet intNodes(numBBs);  /* set of interval nodes        */
 
     /* Structure loops */
     /* for all derived sequences Gi */
@@ -356,7 +314,7 @@ void Function::structLoops(derSeq *derivedG)
 void Function::structCases()
 {
     int exitNode = NO_NODE;   	/* case exit node           */
-    nodeList caseNodes;   /* temporary: list of nodes in case */
+    NodeSet caseNodes(numBBs);  /* temporary: set of nodes in case */
 
     /* Linear scan of the nodes in reverse dfsLast order, searching for
      * case nodes                           */
@@ -368,9 +326,9 @@ void Function::structCases()
 
         /* Find descendant node which has as immediate predecessor
                          * the current header node, and is not a successor.    */
-        for (size_t j = i + 2; j < numBBs; j++)
+        for (int j : m_domTree.children(i))
         {
-            if ((not successor(j, i, this)) and (m_dfsLast[j]->immedDom == i))
+            if ((j >= i + 2) and (not successor(j, i, this)))
             {
                 if (exitNode == NO_NODE)
                     exitNode = j;
@@ -382,7 +340,7 @@ void Function::structCases()
 
         /* Tag nodes that belong to the case by recording the
                          * header field with caseHeader.           */
-        caseNodes.push_back(i);
+        caseNodes.insert(i);
         m_dfsLast[i]->caseHead = i;
         for(TYPEADR_TYPE &pb : caseHeader->edges)
         {
@@ -421,9 +379,9 @@ void Function::structIfs ()
             follow = 0;
 
             /* Find all nodes that have this node as immediate dominator */
-            for (size_t desc = curr+1; desc < numBBs; desc++)
+            for (int desc : m_domTree.children(curr))
             {
-                if (m_dfsLast[desc]->immedDom == curr)
+                if (desc > curr)
                 {
                     domDesc.push_back(desc);
                     pbb = m_dfsLast[desc];
@@ -52,7 +52,7 @@ struct ExpStack
     }
 
 };
-ExpStack g_exp_stk;
+thread_local ExpStack g_exp_stk;
 /** Returns a string with the source operand of Icode */
 Expr *srcIdent (const LLInst &ll_insn, Function * pProc, iICODE i, ICODE & duIcode, operDu du)
 {
@@ -60,7 +60,7 @@ Expr *srcIdent (const LLInst &ll_insn, Function * pProc, iICODE i, ICODE & duIco
     if (src_op->isImmediate())   /* immediate operand ll_insn.testFlags(I)*/
     {
         //if (ll_insn.testFlags(B))
-        return new Constant(src_op->getImm2(), src_op->byteWidth());
+        return Constant::Create(src_op->getImm2(), src_op->byteWidth());
     }
     // otherwise
     return AstIdent::id (ll_insn, SRC, pProc, i, duIcode, du);
@@ -152,7 +152,7 @@ bool ExpStack::empty()
 size_t STKFRAME::getLocVar(int off)
 {
     auto iter=findByLabel(off);
-    return distance(begin(),iter);
+    return std::distance(begin(),iter);
 }
 
 
@@ -206,7 +206,7 @@ void Function::elimCondCodes ()
                         lhs = defIcode.hl()->asgn.lhs()->clone();
                         useAt->copyDU(*defAt, eUSE, eDEF);
                         //if (defAt->ll()->testFlags(B))
-                        rhs = new Constant(0, dest_ll->byteWidth());
+                        rhs = Constant::Create(0, dest_ll->byteWidth());
                         break;
 
                     case iTEST:
@@ -214,13 +214,13 @@ void Function::elimCondCodes ()
                         lhs = dstIdent (*defIcode.ll(),this, befDefAt,*useAt, eUSE);
                         lhs = BinaryOperator::And(lhs, rhs);
                         //                            if (defAt->ll()->testFlags(B))
-                        rhs = new Constant(0, dest_ll->byteWidth());
+                        rhs = Constant::Create(0, dest_ll->byteWidth());
                         break;
                     case iINC:
                     case iDEC: //WARNING: verbatim copy from iOR needs fixing ?
                         lhs = defIcode.hl()->asgn.lhs()->clone();
                         useAt->copyDU(*defAt, eUSE, eDEF);
-                        rhs = new Constant(0, dest_ll->byteWidth());
+                        rhs = Constant::Create(0, dest_ll->byteWidth());
                         break;
                     default:
                         notSup = true;
@@ -240,9 +240,9 @@ void Function::elimCondCodes ()
                 else if (useAtOp == iJCXZ)
                 {
                     //NOTICE: was rCX, 0
-                    lhs = new RegisterNode(LLOperand(rCX, 0 ), &localId);
+                    lhs = RegisterNode::Create(LLOperand(rCX, 0 ), &localId);
                     useAt->setRegDU (rCX, eUSE);
-                    rhs = new Constant(0, 2);
+                    rhs = Constant::Create(0, 2);
                     _expr = BinaryOperator::Create(EQUAL,lhs,rhs);
                     useAt->setJCond(_expr);
                 }
@@ -451,7 +451,7 @@ bool BB::FindUseBeforeDef(eReg regi, int defRegIdx, iICODE start_at)
         return true;
     if ((regi == rSI) and (flg & SI_REGVAR))
         return true;
-    if (distance(start_at,end())>1) /* several instructions */
+    if (std::distance(start_at,end())>1) /* several instructions */
     {
         iICODE ticode=end();
         // Only check uses of HIGH_LEVEL icodes
@@ -709,7 +709,7 @@ int C_CallingConvention::processCArg (Function * callee, Function * pProc, ICODE
                                     size_of_arg += 2;
                                 }
                             } else if(idn) {
-                                Expr *tmp1 = new Constant(2,1);
+                                Expr *tmp1 = Constant::Create(2,1);
                                 Expr *tmp2 = BinaryOperator::createSHL(_exp,tmp1);
                                 _exp = BinaryOperator::CreateAdd(g_exp_stk.top(),tmp2);
                                 g_exp_stk.pop(); // pop segment
@@ -1278,6 +1278,8 @@ void Function::preprocessReturnDU(LivenessSet &_liveOut)
  \note indirect recursion in liveRegAnalysis is possible. */
 void Function::dataFlow(LivenessSet &_liveOut)
 {
+    PhaseTimer timer(PH_DATA_FLOW, this);
+    ExprArena::Scope exprScope(exprs);
 
     /* Remove references to register variables */
     if (flg & SI_REGVAR)
@@ -10,22 +10,31 @@
 #include "project.h"
 #include "CallGraph.h"
 #include "DccFrontend.h"
+#include "TaskGraph.h"
+#include "Profiler.h"
 
+#include <atomic>
 #include <cstring>
+#include <cstdlib>
 #include <iostream>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QCommandLineParser>
 
 #include <QtCore/QFile>
 
 
 /* Global variables - extern to other modules */
-extern QString asm1_name, asm2_name;     /* Assembler output filenames     */
+extern thread_local QString asm1_name, asm2_name; /* Assembler output filenames */
 extern SYMTAB  symtab;             /* Global symbol table      			  */
-extern STATS   stats;              /* cfg statistics       				  */
+extern thread_local STATS stats;   /* cfg statistics       				  */
 extern OPTION  option;             /* Command line options     			  */
 
+static QStringList inputs;          /* Files to decompile, directories expanded */
+static std::vector<std::string> profiles; /* --profile figures of each input */
 static void displayTotalStats();
+
 /****************************************************************************
  * main
  ***************************************************************************/
@@ -55,19 +64,52 @@ void setupOptions(const QCoreApplication &app) {
                                         QCoreApplication::translate("main", "offset"),
                                         "0"
                                         );
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+                                  QCoreApplication::translate("main", "Analyse procedures, or whole files in batch mode, on <N> threads, 0 uses every core"),
+                                  QCoreApplication::translate("main", "N"),
+                                  "1"
+                                  );
     parser.addOption(targetFileOption);
     parser.addOption(assembly);
     parser.addOption(entryPointOption);
+    QCommandLineOption legacyDecodeOption(QStringList() << "legacy-decode",
+                                          QCoreApplication::translate("main", "Decode instructions with the original scanner state table"));
+    parser.addOption(jobsOption);
+    QCommandLineOption readImageOption(QStringList() << "read-image",
+                                       QCoreApplication::translate("main", "Read the input file into memory instead of mapping it"));
+    parser.addOption(legacyDecodeOption);
+    parser.addOption(readImageOption);
+    QCommandLineOption profileOption(QStringList() << "profile",
+                                     QCoreApplication::translate("main", "Write the time and memory taken by each phase, for the program and each procedure, as JSON to <file>"),
+                                     QCoreApplication::translate("main", "file"));
+    parser.addOption(profileOption);
     //parser.addOption(forceOption);
     // Process the actual command line arguments given by the user
-    parser.addPositionalArgument("source", QCoreApplication::translate("main", "Dos Executable file to decompile."));
+    parser.addPositionalArgument("source", QCoreApplication::translate("main", "Dos Executable file to decompile. Several files, or the programs in a directory, are decompiled as a batch."),
+                                 "source...");
     parser.process(app);
 
     const QStringList args = parser.positionalArguments();
     if(args.empty()) {
         parser.showHelp();
     }
-    // source is args.at(0), destination is args.at(1)
+    for(const QString &arg : args) {
+        if(QFileInfo(arg).isDir()) {
+            QDir dir(arg);
+            QStringList programs;
+            programs << "*.exe" << "*.com" << "*.EXE" << "*.COM";
+            for(const QString &name : dir.entryList(programs, QDir::Files, QDir::Name))
+                inputs << dir.filePath(name);
+            option.Batch = true;
+        }
+        else
+            inputs << arg;
+    }
+    if(inputs.empty()) {
+        fprintf(stderr, "dcc: no input files\n");
+        exit(1);
+    }
+    option.Batch = option.Batch or inputs.size() > 1;
     option.verbose = parser.isSet(boolOpts[0]);
     option.VeryVerbose = parser.isSet(boolOpts[1]);
     if(parser.isSet(assembly)) {
@@ -78,9 +120,22 @@ void setupOptions(const QCoreApplication &app) {
     option.Stats = parser.isSet(boolOpts[4]);
     option.Interact = false;
     option.Calls = parser.isSet(boolOpts[2]);
-    option.filename = args.first();
+    option.filename = inputs.first();
     option.CustomEntryPoint = parser.value(entryPointOption).toUInt(nullptr,16);
-    if(parser.isSet(targetFileOption))
+    option.Jobs = parser.value(jobsOption).toUInt();
+    if(option.Jobs==0)
+        option.Jobs = TaskGraph::hardwareJobs();
+    option.LegacyDecode = parser.isSet(legacyDecodeOption);
+    option.ReadImage = parser.isSet(readImageOption);
+    option.ProfileFile = parser.value(profileOption);
+    if(not option.ProfileFile.isEmpty())
+        Profiler::enable();
+    if(option.Batch) {
+        if(parser.isSet(targetFileOption))
+            fprintf(stderr, "dcc: -o is ignored in batch mode\n");
+        /* Assembler file names are set for each input */
+    }
+    else if(parser.isSet(targetFileOption))
         asm1_name = asm2_name = parser.value(targetFileOption);
     else if(option.asm1 or option.asm2) {
         asm1_name = option.filename+".a1";
@@ -88,25 +143,21 @@ void setupOptions(const QCoreApplication &app) {
     }
 
 }
-int main(int argc, char **argv)
+/* Decompiles filename into proj, which must be the current project */
+static int decompile(Project &proj, const QString &filename, QObject *parent)
 {
-    QCoreApplication app(argc,argv);
-
-    QCoreApplication::setApplicationVersion("0.1");
-    setupOptions(app);
-
     /* Front end reads in EXE or COM file, parses it into I-code while
      * building the call graph and attaching appropriate bits of code for
      * each procedure.
     */
-    Project::get()->create(option.filename);
+    proj.create(filename);
 
-    DccFrontend fe(&app);
-    if(not Project::get()->load()) {
+    DccFrontend fe(parent);
+    if(not proj.load()) {
         return -1;
     }
     if (option.verbose)
-        Project::get()->prog.displayLoadInfo();
+        proj.prog.displayLoadInfo();
     if(false==fe.FrontEnd ())
         return -1;
     if(option.asm1)
@@ -123,9 +174,9 @@ int main(int argc, char **argv)
      * analysis, data flow etc. and outputs it to output file ready for
      * re-compilation.
     */
-    BackEnd(Project::get()->callGraph);
+    BackEnd(proj.callGraph);
 
-    Project::get()->callGraph->write();
+    proj.callGraph->write();
 
     if (option.Stats)
         displayTotalStats();
@@ -133,6 +184,67 @@ int main(int argc, char **argv)
     return 0;
 }
 
+/* Decompiles every input, option.Jobs of them at a time.  Each one gets its
+ * own Project, which the threads analysing its procedures share; the
+ * signature and prototype tables are loaded by the first input needing them
+ * and shared.  With several inputs the threads go to the inputs, each one's
+ * procedures being done on its own thread, so no more than option.Jobs run. */
+static int decompileBatch()
+{
+    std::atomic<int> failed(0);
+    TaskGraph tasks;
+    profiles.resize(Profiler::enabled() ? inputs.size() : 0);
+    unsigned procJobs = (inputs.size() > 1) ? 1 : 0;
+    for(size_t i = 0; i < size_t(inputs.size()); i++)
+    {
+        const QString &filename(inputs[i]);
+        tasks.addTask([i,&filename,&failed,procJobs]() {
+            Project proj;
+            proj.jobs = procJobs;
+            Project::setCurrent(&proj);
+            stats = STATS();
+            asm1_name = filename+".a1";
+            asm2_name = filename+".a2";
+            try {
+                if(decompile(proj, filename, nullptr) != 0)
+                    failed++;
+            }
+            catch(const FatalError &) {
+                fprintf(stderr, "dcc: giving up on %s\n", qPrintable(filename));
+                failed++;
+            }
+            if(Profiler::enabled())
+                profiles[i] = Profiler::toJson(proj);
+            Project::setCurrent(nullptr);
+        });
+    }
+    tasks.run(option.Jobs);
+    if(failed)
+        fprintf(stderr, "dcc: %d of %d files failed\n", int(failed), int(inputs.size()));
+    return failed ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc,argv);
+
+    QCoreApplication::setApplicationVersion("0.1");
+    setupOptions(app);
+
+    int res;
+    if(option.Batch)
+        res = decompileBatch();
+    else
+    {
+        res = decompile(*Project::get(), option.filename, &app);
+        if(Profiler::enabled())
+            profiles.push_back(Profiler::toJson(*Project::get()));
+    }
+    if(Profiler::enabled())
+        Profiler::write(option.ProfileFile, profiles);
+    return res;
+}
+
 static void
 displayTotalStats ()
 /* Displays final statistics for the complete program */
@@ -142,6 +254,19 @@ displayTotalStats ()
     printf ("  Total number of high-level Icodes: %d\n", stats.totalHL);
     printf ("  Total reduction of instructions  : %2.2f%%\n", 100.0 -
             (stats.totalHL * 100.0) / stats.totalLL);
+    const DecodeCache &cache(Project::get()->decodeCache);
+    printf ("  Decode cache hits / misses       : %d / %d\n", cache.hits(), cache.misses());
+    size_t nodes = Project::get()->exprs.nodes();
+    size_t bytes = Project::get()->exprs.bytes();
+    size_t shared = Project::get()->exprs.sharedLeaves();
+    for (const Function &f : Project::get()->pProcList)
+    {
+        nodes += f.exprs.nodes();
+        bytes += f.exprs.bytes();
+        shared += f.exprs.sharedLeaves();
+    }
+    printf ("  Expression nodes / bytes         : %zu / %zu\n", nodes, bytes);
+    printf ("  Shared expression leaves         : %zu\n", shared);
 }
 
 
@@ -63,8 +63,6 @@ public:
 };
 
 IDcc* IDcc::get() {
-    static IDcc *v=0;
-    if(nullptr == v)
-        v = new DccImpl;
+    static IDcc *v = new DccImpl;
     return v;
 }
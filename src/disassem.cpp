@@ -85,20 +85,20 @@ static char *strHex(uint32_t d);
 bool callArg(uint16_t off, char *temp);  /* Check for procedure name */
 
 //static  FILE   *dis_g_fp;
-static  CIcodeRec pc;
-static  int     cb, j, numIcode, allocIcode;
-static  map<int,int> pl;
-static  uint32_t   nextInst;
-static  bool    fImpure;
+static thread_local CIcodeRec pc;
+static thread_local int     cb, j, numIcode, allocIcode;
+static thread_local map<int,int> pl;
+static thread_local uint32_t   nextInst;
+static thread_local bool    fImpure;
 //static  int     g_lab;
-static  Function *   pProc;          /* Points to current proc struct */
+static thread_local Function *   pProc;          /* Points to current proc struct */
 
 struct POSSTACK_ENTRY
 {
     int     ic;                 /* An icode offset */
     Function *   pProc;              /* A pointer to a PROCEDURE structure */
 } ;
-static vector<POSSTACK_ENTRY> posStack; /* position stack */
+static thread_local vector<POSSTACK_ENTRY> posStack; /* position stack */
 //static uint8_t              iPS;          /* Index into the stack */
 
 
@@ -650,7 +650,7 @@ QTextStream &LLInst::strSrc(QTextStream &os,bool skip_comma)
  ****************************************************************************/
 static char *strHex(uint32_t d)
 {
-    static char buf[10];
+    static thread_local char buf[10];
 
     d &= 0xFFFF;
     sprintf(buf, "0%X%s", d, (d > 9)? "h": "");
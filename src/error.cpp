@@ -34,7 +34,8 @@ static const std::map<eErrorId,std::string> errorMessage =
 };
 
 /****************************************************************************
- fatalError: displays error message and exits the program.
+ fatalError: displays error message and exits the program, or in batch mode
+ abandons the current input.
  ****************************************************************************/
 void fatalError(eErrorId errId, ...)
 {
@@ -58,6 +59,8 @@ void fatalError(eErrorId errId, ...)
         vfprintf(stderr, msg_iter->second.c_str(), args);
     }
     va_end(args);
+    if (option.Batch)
+        throw FatalError{errId};
     exit((int)errId);
 }
 
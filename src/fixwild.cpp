@@ -18,7 +18,7 @@
 #define WILD            0xF4
 #endif
 
-static int pc;                              /* Indexes into pat[] */
+static thread_local int pc;                 /* Indexes into pat[] */
 
 /* prototypes */
 static bool ModRM(uint8_t pat[]);              /* Handle the mod/rm uint8_t */
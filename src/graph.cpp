@@ -191,10 +191,7 @@ void Function::markImpure()
  ****************************************************************************/
 void Function::freeCFG()
 {
-    for(auto p : m_ip_to_bb)
-    {
-        delete p.second;
-    }
+    cfgNodes.release();
     m_ip_to_bb.clear();
 }
 
@@ -244,10 +241,7 @@ void Function::compressCFG()
             if (entry_node)	/* Init it misses out on */
                 pBB->index = UN_INIT;
             else
-            {
-                delete pBB;
-                stats.numBBaft--;
-            }
+                stats.numBBaft--;   /* Freed with the rest of the graph */
         }
         else
         {
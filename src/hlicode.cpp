@@ -333,7 +333,7 @@ void Function::highLevelGen()
             }
         if(ll->getOpcode()==iPUSH) {
             if(ll->testFlags(I)) {
-                lhs = new Constant(src_ll->opz,src_ll->byteWidth());
+                lhs = Constant::Create(src_ll->opz,src_ll->byteWidth());
             }
 //            lhs = AstIdent::id (*pIcode->ll(), DST, this, i, *pIcode, NONE);
         }
@@ -358,7 +358,7 @@ void Function::highLevelGen()
                 break;
 
             case iDEC:
-                rhs = new BinaryOperator(SUB,lhs, new Constant(1, 2));
+                rhs = new BinaryOperator(SUB,lhs, Constant::Create(1, 2));
                 pIcode->setAsgn(lhs, rhs);
                 break;
 
@@ -367,7 +367,7 @@ void Function::highLevelGen()
             {
                 eReg v = ( dst_ll->byteWidth()==1) ? rAL:rAX;
                 rhs = new BinaryOperator(DIV,lhs, rhs);
-                lhs = new RegisterNode(LLOperand(v, dst_ll->byteWidth()), &localId);
+                lhs = RegisterNode::Create(LLOperand(v, dst_ll->byteWidth()), &localId);
                 pIcode->setRegDU( v, eDEF);
                 pIcode->setAsgn(lhs, rhs);
             }
@@ -380,7 +380,7 @@ void Function::highLevelGen()
                 break;
 
             case iINC:
-                rhs = new BinaryOperator(ADD,lhs, new Constant(1, 2));
+                rhs = new BinaryOperator(ADD,lhs, Constant::Create(1, 2));
                 pIcode->setAsgn(lhs, rhs);
                 break;
 
@@ -393,7 +393,7 @@ void Function::highLevelGen()
             {
                 rhs = new BinaryOperator(MOD,lhs, rhs);
                 eReg lhs_reg = (dst_ll->byteWidth()==1) ? rAH : rDX;
-                lhs = new RegisterNode(LLOperand(lhs_reg, dst_ll->byteWidth()), &localId);
+                lhs = RegisterNode::Create(LLOperand(lhs_reg, dst_ll->byteWidth()), &localId);
                 pIcode->setRegDU( lhs_reg, eDEF);
                 pIcode->setAsgn(lhs, rhs);
             }
@@ -508,7 +508,6 @@ QString writeJcond (const HLTYPE &h, Function * pProc, int *numLoc)
     Expr *inverted=h.expr()->inverse();
     //inverseCondOp (&h.exp);
     QString inverted_form = inverted->walkCondExpr (pProc, numLoc);
-    delete inverted;
 
     return QString("if %1 {\n").arg(inverted_form);
 }
@@ -4,7 +4,6 @@
 void HLTYPE::replaceExpr(Expr *e)
 {
     assert(e);
-    delete exp.v;
     exp.v=e;
 }
 
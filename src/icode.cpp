@@ -14,14 +14,35 @@ ICODE::TypeAndValidFilter<HIGH_LEVEL_ICODE> ICODE::select_valid_high_level;
 CIcodeRec::CIcodeRec()
 {
 }
+CIcodeRec::CIcodeRec(const CIcodeRec &other) : ChunkedVector<ICODE>(other)
+{
+    for(iterator iter=begin(); iter!=end(); ++iter)
+        m_labels.emplace(iter->ll()->label,iter);
+}
+CIcodeRec &CIcodeRec::operator=(const CIcodeRec &other)
+{
+    if(this==&other)
+        return *this;
+    ChunkedVector<ICODE>::operator=(other);
+    m_labels.clear();
+    for(iterator iter=begin(); iter!=end(); ++iter)
+        m_labels.emplace(iter->ll()->label,iter);
+    return *this;
+}
+void CIcodeRec::clear()
+{
+    ChunkedVector<ICODE>::clear();
+    m_labels.clear();
+}
 
-/* Copies the icode that is pointed to by pIcode to the icode array.
- * If there is need to allocate extra memory, it is done so, and
- * the alloc variable is adjusted.        */
+/* Copies the icode that is pointed to by pIcode to the icode array, and
+ * records its label, unless an earlier icode (e.g. the synthetic MOV placed
+ * before a DIV or XCHG) already carries it.        */
 ICODE * CIcodeRec::addIcode(ICODE *pIcode)
 {
     push_back(*pIcode);
     back().loc_ip = size()-1;
+    m_labels.emplace(back().ll()->label,iterator(this,size()-1));
     return &back();
 }
 
@@ -50,18 +71,19 @@ bool CIcodeRec::alreadyDecoded(uint32_t target)
 }
 CIcodeRec::iterator CIcodeRec::labelSrch(uint32_t target)
 {
-    return find_if(begin(),end(),[target](ICODE &l) -> bool {return l.ll()->label==target;});
+    auto found=m_labels.find(target);
+    if(found==m_labels.end())
+        return end();
+    return found->second;
 }
 ICODE * CIcodeRec::GetIcode(size_t ip)
 {
     assert(ip<size());
-    iICODE res=begin();
-    advance(res,ip);
-    return &(*res);
+    return &(*this)[ip];
 }
 
 extern int getNextLabel();
-extern bundle cCode;
+extern thread_local bundle cCode;
 /* Checks the given icode to determine whether it has a label associated
  * to it.  If so, a goto is emitted to this label; otherwise, a new label
  * is created and a goto is also emitted.
@@ -79,7 +101,8 @@ void LLInst::emitGotoLabel (int indLevel)
                  * the code */
         cCode.code.addLabelBundle (codeIdx, hllLabNum);
     }
-    cCode.appendCode( "%sgoto L%ld;\n", indentStr(indLevel), hllLabNum);
+    std::string before = std::string(indentStr(indLevel)) + "goto L";
+    cCode.code.appendWithLabel(before.c_str(), hllLabNum, ";\n");
     stats.numHLIcode++;
 }
 
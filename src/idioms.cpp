@@ -90,11 +90,11 @@ void Function::findIdioms()
         {
         case iDEC: case iINC:
             if (i18.match(pIcode))
-                advance(pIcode,i18.action());
+                std::advance(pIcode,i18.action());
             else if (i19.match(pIcode))
-                advance(pIcode,i19.action());
+                std::advance(pIcode,i19.action());
             else if (i20.match(pIcode))
-                advance(pIcode,i20.action());
+                std::advance(pIcode,i20.action());
             else
                 pIcode++;
             break;
@@ -103,18 +103,18 @@ void Function::findIdioms()
         {
             /* Idiom 1 */
             //TODO: add other push idioms.
-            advance(pIcode,i01(pIcode));
+            std::advance(pIcode,i01(pIcode));
             break;
         }
 
         case iMOV:
         {
             if (i02.match(pIcode)) /* Idiom 2 */
-                advance(pIcode,i02.action());
+                std::advance(pIcode,i02.action());
             else if (i14.match(pIcode))  /* Idiom 14 */
-                advance(pIcode,i14.action());
+                std::advance(pIcode,i14.action());
             else if (i13.match(pIcode))      /* Idiom 13 */
-                advance(pIcode,i13.action());
+                std::advance(pIcode,i13.action());
             else
                 pIcode++;
             break;
@@ -134,52 +134,52 @@ void Function::findIdioms()
 
             /* Check for idioms */
             if (i03.match(pIcode))         /* idiom 3 */
-                advance(pIcode,i03.action());
+                std::advance(pIcode,i03.action());
             else if (i17.match(pIcode))  /* idiom 17 */
-                advance(pIcode,i17.action());
+                std::advance(pIcode,i17.action());
             else
                 pIcode++;
             break;
 
         case iRET:          /* Idiom 4 */
         case iRETF:
-            advance(pIcode,i04(pIcode));
+            std::advance(pIcode,i04(pIcode));
             break;
 
         case iADD:          /* Idiom 5 */
-            advance(pIcode,i05(pIcode));
+            std::advance(pIcode,i05(pIcode));
             break;
 
         case iSAR:          /* Idiom 8 */
-            advance(pIcode,i08(pIcode));
+            std::advance(pIcode,i08(pIcode));
             break;
 
         case iSHL:
             if (i15.match(pIcode))       /* idiom 15 */
-                advance(pIcode,i15.action());
+                std::advance(pIcode,i15.action());
             else if (i12.match(pIcode))        /* idiom 12 */
-                advance(pIcode,i12.action());
+                std::advance(pIcode,i12.action());
             else
                 pIcode++;
             break;
 
         case iSHR:          /* Idiom 9 */
-            advance(pIcode,i09(pIcode));
+            std::advance(pIcode,i09(pIcode));
             break;
 
         case iSUB:          /* Idiom 6 */
-            advance(pIcode,i06(pIcode));
+            std::advance(pIcode,i06(pIcode));
             break;
 
         case iOR:           /* Idiom 10 */
-            advance(pIcode,i10(pIcode));
+            std::advance(pIcode,i10(pIcode));
             break;
 
         case iNEG:          /* Idiom 11 */
             if (i11.match(pIcode))
-                advance(pIcode,i11.action());
+                std::advance(pIcode,i11.action());
             else if (i16.match(pIcode))
-                advance(pIcode,i16.action());
+                std::advance(pIcode,i16.action());
             else
                 pIcode++;
             break;
@@ -198,9 +198,9 @@ void Function::findIdioms()
 
         case iXOR:          /* Idiom 7 */
             if (i21.match(pIcode))
-                advance(pIcode,i21.action());
+                std::advance(pIcode,i21.action());
             else if (i07.match(pIcode))
-                advance(pIcode,i07.action());
+                std::advance(pIcode,i07.action());
             else
                 ++pIcode;
             break;
@@ -276,7 +276,7 @@ void Function::bindIcodeOff()
 /** Performs idioms analysis, and propagates long operands, if any */
 void Function::lowLevelAnalysis ()
 {
-
+    PhaseTimer timer(PH_LOW_LEVEL, this);
     findIdioms(); // Idiom analysis - sets up some flags and creates some HIGH_LEVEL icodes
     propLong();   // Propagate HIGH_LEVEL idiom information for long operands
 }
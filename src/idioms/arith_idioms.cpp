@@ -233,7 +233,7 @@ int Idiom19::action()
 
     lhs = AstIdent::id (*m_icodes[0]->ll(), DST, m_func, m_icodes[0], *m_icodes[1], eUSE);
     lhs = UnaryOperator::Create(m_is_dec ? PRE_DEC : PRE_INC, lhs);
-    expr = new BinaryOperator(condOpJCond[m_icodes[1]->ll()->getOpcode() - iJB],lhs, new Constant(0, 2));
+    expr = new BinaryOperator(condOpJCond[m_icodes[1]->ll()->getOpcode() - iJB],lhs, Constant::Create(0, 2));
     m_icodes[1]->setJCond(expr);
     m_icodes[0]->invalidate();
     return 2;
@@ -50,7 +50,7 @@ bool Idiom2::match(iICODE pIcode)
         return false;
     if ( pIcode->ll()->testFlags(I) or (not pIcode->ll()->match(rSP,rBP)) )
         return false;
-    if(distance(pIcode,m_end)<3)
+    if(std::distance(pIcode,m_end)<3)
         return false;
     /* Matched MOV SP, BP */
     m_icodes.clear();
@@ -75,7 +75,7 @@ bool Idiom2::match(iICODE pIcode)
                 )
         {
             m_icodes.push_back(nicode); // Matched RET
-            advance(pIcode,-2); // move back before our start
+            std::advance(pIcode,-2); // move back before our start
             popStkVars (pIcode); // and add optional pop di/si to m_icodes
             return true;
         }
@@ -110,10 +110,10 @@ bool Idiom4::match(iICODE pIcode)
     m_param_count = 0;
     /* Check for [POP DI]
      *           [POP SI] */
-    if(distance(m_func->Icode.begin(),pIcode)>=3)
+    if(std::distance(m_func->Icode.begin(),pIcode)>=3)
     {
         iICODE search_at(pIcode);
-        advance(search_at,-3);
+        std::advance(search_at,-3);
         popStkVars(search_at);
     }
     if(pIcode != m_func->Icode.begin())
@@ -125,7 +125,7 @@ bool Idiom4::match(iICODE pIcode)
         else if(prev1!=m_func->Icode.begin())
         {
             iICODE search_at(pIcode);
-            advance(search_at,-2);
+            std::advance(search_at,-2);
             popStkVars (search_at);
         }
     }
@@ -106,7 +106,7 @@ int Idiom13::action()
     eReg regi = m_icodes[0]->ll()->m_dst.regi;
     m_icodes[0]->du1.removeDef(regi);
     //m_icodes[0]->du1.numRegsDef--;   	/* prev uint8_t reg def */
-    lhs = new RegisterNode(LLOperand(m_loaded_reg, 0), &m_func->localId);
+    lhs = RegisterNode::Create(LLOperand(m_loaded_reg, 0), &m_func->localId);
     m_icodes[0]->setRegDU( m_loaded_reg, eDEF);
     rhs = AstIdent::id (*m_icodes[0]->ll(), SRC, m_func, m_icodes[0], *m_icodes[0], NONE);
     m_icodes[0]->setAsgn(lhs, rhs);
@@ -40,7 +40,7 @@ int Idiom8::action()
     lhs = AstIdent::LongIdx (idx);
     m_icodes[0]->setRegDU( regL, USE_DEF);
 
-    expr = new BinaryOperator(SHR,lhs, new Constant(1, 2));
+    expr = new BinaryOperator(SHR,lhs, Constant::Create(1, 2));
     m_icodes[0]->setAsgn(lhs, expr);
     m_icodes[1]->invalidate();
     return 2;
@@ -84,8 +84,8 @@ int Idiom15::action()
     AstIdent *lhs;
 
     Expr *rhs,*_exp;
-    lhs = new RegisterNode(*m_icodes[0]->ll()->get(DST), &m_func->localId);
-    rhs = new Constant(m_icodes.size(), 2);
+    lhs = RegisterNode::Create(*m_icodes[0]->ll()->get(DST), &m_func->localId);
+    rhs = Constant::Create(m_icodes.size(), 2);
     _exp = new BinaryOperator(SHL,lhs, rhs);
     m_icodes[0]->setAsgn(lhs, _exp);
     for (size_t i=1; i<m_icodes.size()-1; ++i)
@@ -129,7 +129,7 @@ int Idiom12::action()
     idx = m_func->localId.newLongReg (TYPE_LONG_UNSIGN, LONGID_TYPE(regH,regL),m_icodes[0]);
     lhs = AstIdent::LongIdx (idx);
     m_icodes[0]->setRegDU( regH, USE_DEF);
-    expr = new BinaryOperator(SHL,lhs, new Constant(1, 2));
+    expr = new BinaryOperator(SHL,lhs, Constant::Create(1, 2));
     m_icodes[0]->setAsgn(lhs, expr);
     m_icodes[1]->invalidate();
     return 2;
@@ -167,7 +167,7 @@ int Idiom9::action()
     idx = m_func->localId.newLongReg (TYPE_LONG_UNSIGN,LONGID_TYPE(regH,regL),m_icodes[0]);
     lhs = AstIdent::LongIdx (idx);
     m_icodes[0]->setRegDU(regL, USE_DEF);
-    expr = new BinaryOperator(SHR,lhs, new Constant(1, 2));
+    expr = new BinaryOperator(SHR,lhs, Constant::Create(1, 2));
     m_icodes[0]->setAsgn(lhs, expr);
     m_icodes[1]->invalidate();
     return 2;
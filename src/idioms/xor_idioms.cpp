@@ -46,7 +46,7 @@ int Idiom21::action()
     AstIdent *lhs;
 
     lhs = AstIdent::Long (&m_func->localId, DST, m_icodes[0],HIGH_FIRST, m_icodes[0], eDEF, *m_icodes[1]->ll());
-    rhs = new Constant(m_icodes[1]->ll()->src().getImm2(), 4);
+    rhs = Constant::Create(m_icodes[1]->ll()->src().getImm2(), 4);
     m_icodes[0]->setAsgn(lhs, rhs);
     m_icodes[0]->du.use.reset();		/* clear register used in iXOR */
     m_icodes[1]->invalidate();
@@ -89,7 +89,7 @@ int Idiom7::action()
 {
     Expr *lhs;
     lhs = AstIdent::id (*m_icode->ll(), DST, m_func, m_icode, *m_icode, NONE);
-    m_icode->setAsgn(dynamic_cast<AstIdent *>(lhs), new Constant(0, 2));
+    m_icode->setAsgn(dynamic_cast<AstIdent *>(lhs), Constant::Create(0, 2));
     m_icode->du.use.reset();    /* clear register used in iXOR */
     m_icode->ll()->setFlags(I);
     return 1;
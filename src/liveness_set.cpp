@@ -43,12 +43,12 @@ bool LivenessSet::testRegAndSubregs(int r) const
 }
 void LivenessSet::postProcessCompositeRegs()
 {
-    if(testReg(rAL) and testReg(rAH))
-        registers.insert(rAX);
-    if(testReg(rCL) and testReg(rCH))
-        registers.insert(rCX);
-    if(testReg(rDL) and testReg(rDH))
-        registers.insert(rDX);
-    if(testReg(rBL) and testReg(rBH))
-        registers.insert(rBX);
+    /* byte halves and the word register they make up */
+    static const LivenessSet composites[][2] = {
+        { {rAL,rAH}, {rAX} }, { {rCL,rCH}, {rCX} },
+        { {rDL,rDH}, {rDX} }, { {rBL,rBH}, {rBX} }
+    };
+    for(const LivenessSet (&c)[2] : composites)
+        if((registers & c[0].registers)==c[0].registers)
+            registers |= c[1].registers;
 }
@@ -15,6 +15,34 @@
 static const int LOCAL_ID_DELTA = 25;
 static const int IDX_ARRAY_DELTA = 5;
 
+/* Keys of the LOCAL_ID lookup indices */
+static uint64_t regKey(hlType t, eReg regi)
+{
+    return (uint64_t(t) << 32) | uint32_t(regi);
+}
+static uint64_t stkKey(int off, uint8_t regOff)
+{
+    return (uint64_t(uint32_t(off)) << 8) | regOff;
+}
+static uint64_t glbKey(int16_t seg, int16_t off, eReg regi)
+{
+    return (uint64_t(uint16_t(seg)) << 48) | (uint64_t(uint16_t(off)) << 32) | uint32_t(regi);
+}
+static uint64_t pairKey(eReg h, eReg l)
+{
+    return (uint64_t(h) << 32) | uint32_t(l);
+}
+/* Long stack offsets are operand offsets, which are 16 bit */
+static uint64_t longStkKey(hlType t, int offH, int offL)
+{
+    return (uint64_t(t) << 32) | (uint32_t(uint16_t(offH)) << 16) | uint16_t(offL);
+}
+static uint64_t longGlbKey(int16_t seg, int16_t offH, int16_t offL, uint8_t regi=0)
+{
+    return (uint64_t(regi) << 48) | (uint64_t(uint16_t(seg)) << 32) |
+            (uint32_t(uint16_t(offH)) << 16) | uint16_t(offL);
+}
+
 
 bool LONGID_TYPE::srcDstRegMatch(iICODE a, iICODE b) const
 {
@@ -78,21 +106,41 @@ void LOCAL_ID::newIdent(hlType t, frameType f)
     id_arr.emplace_back(t,f);
 }
 
+/* Adds the entry just appended, its fields filled in, to the lookup indices
+ * it can be found by, and returns its index.  An index keeps the first entry
+ * with a given key, as the scans these replace did. */
+int LOCAL_ID::indexLast()
+{
+    int idx = id_arr.size() - 1;
+    const ID &entry(id_arr.back());
+    m_byReg.emplace(regKey(entry.type, entry.id.regi), idx);
+    m_byStk.emplace(stkKey(entry.id.bwId.off, entry.id.bwId.regOff), idx);
+    if ((entry.typeBitsize()<=16) and (entry.id.bwId.regOff == 0))
+        m_byFrameOff.emplace(uint32_t(entry.id.bwId.off), idx);
+    m_byGlb.emplace(glbKey(entry.id.bwGlb.seg, entry.id.bwGlb.off, entry.id.bwGlb.regi), idx);
+    if (entry.isLongRegisterPair())
+        m_byLongReg.emplace(pairKey(entry.longId().h(), entry.longId().l()), idx);
+    if ((entry.loc == STK_FRAME) and entry.isLong())
+        m_byLongStk.emplace(longStkKey(entry.type, entry.longStkId().offH, entry.longStkId().offL), idx);
+    const LONGGLB_TYPE &glb(entry.id.longGlb);
+    m_byLongGlb.emplace(longGlbKey(glb.seg, glb.offH, glb.offL), idx);
+    m_byLongIdx.emplace(longGlbKey(glb.seg, glb.offH, glb.offL, glb.regi), idx);
+    return idx;
+}
+
 
 /* Creates a new register identifier node of TYPE_BYTE_(UN)SIGN or
  * TYPE_WORD_(UN)SIGN type.  Returns the index to this new entry.       */
 int LOCAL_ID::newByteWordReg(hlType t, eReg regi)
 {
     /* Check for entry in the table */
-    auto found=std::find_if(id_arr.begin(),id_arr.end(),[t,regi](ID &el)->bool {
-        return ((el.type == t) and (el.id.regi == regi));
-    });
-    if(found!=id_arr.end())
-        return found-id_arr.begin();
+    auto found = m_byReg.find(regKey(t, regi));
+    if(found!=m_byReg.end())
+        return found->second;
     /* Not in table, create new identifier */
     newIdent (t, REG_FRAME);
     id_arr.back().id.regi = regi;
-    return id_arr.size() - 1;
+    return indexLast();
 }
 
 
@@ -104,16 +152,25 @@ int LOCAL_ID::newByteWordReg(hlType t, eReg regi)
  *       flagging this entry as illegal is all that can be done.    */
 void LOCAL_ID::flagByteWordId (int off)
 {
-    auto found=std::find_if(id_arr.begin(),id_arr.end(),[off](ID &en)->bool {
-            //if (((en.type == TYPE_WORD_SIGN) or (en.type == TYPE_BYTE_SIGN)) and
-            return ((en.typeBitsize()<=16) and (en.id.bwId.off == off) and (en.id.bwId.regOff == 0));
-    });
-    if(found==id_arr.end())
+    auto found = m_byFrameOff.find(uint32_t(off));
+    if(found==m_byFrameOff.end())
     {
         printf("No entry to flag as invalid in LOCAL_ID::flagByteWordId \n");
         return;
     }
-    found->illegal = true;
+    id_arr[found->second].illegal = true;
+}
+
+int LOCAL_ID::findByteWordStk(int off, uint8_t regOff) const
+{
+    auto found = m_byStk.find(stkKey(off, regOff));
+    return found==m_byStk.end() ? int(id_arr.size()) : found->second;
+}
+
+int LOCAL_ID::findIntIdx(int16_t seg, int16_t off, eReg regi) const
+{
+    auto found = m_byGlb.find(glbKey(seg, off, regi));
+    return found==m_byGlb.end() ? int(id_arr.size()) : found->second;
 }
 
 /* Creates a new stack identifier node of TYPE_BYTE_(UN)SIGN or
@@ -121,20 +178,16 @@ void LOCAL_ID::flagByteWordId (int off)
 int LOCAL_ID::newByteWordStk(hlType t, int off, uint8_t regOff)
 {
     /* Check for entry in the table */
-    auto found=std::find_if(id_arr.begin(),id_arr.end(),[off,regOff](ID &el)->bool {
-        if ((el.id.bwId.off == off) and (el.id.bwId.regOff == regOff))
-            return true;
-        return false;
-    });
-    if(found!=id_arr.end())
-        return found-id_arr.begin(); //return Index to found element
+    int found = findByteWordStk(off, regOff);
+    if(found!=int(id_arr.size()))
+        return found; //return Index to found element
 
     /* Not in table, create new identifier */
     newIdent (t, STK_FRAME);
     ID &last_id(id_arr.back());
     last_id.id.bwId.regOff = regOff;
     last_id.id.bwId.off = off;
-    return id_arr.size()-1;
+    return indexLast();
 }
 
 
@@ -149,22 +202,17 @@ int LOCAL_ID::newByteWordStk(hlType t, int off, uint8_t regOff)
  *            t: HIGH_LEVEL type            */
 int LOCAL_ID::newIntIdx(int16_t seg, int16_t off, eReg regi, hlType t)
 {
-    /* Check for entry in the table */
-    for (size_t idx = 0; idx < id_arr.size(); idx++)
-    {
-        if (/*(locSym->id[idx].type == t) and   Not checking type */
-                (id_arr[idx].id.bwGlb.seg == seg) and
-                (id_arr[idx].id.bwGlb.off == off) and
-                (id_arr[idx].id.bwGlb.regi == regi))
-            return (idx);
-    }
+    /* Check for entry in the table, not checking type */
+    int found = findIntIdx(seg, off, regi);
+    if(found!=int(id_arr.size()))
+        return found;
 
     /* Not in the table, create new identifier */
     newIdent (t, GLB_FRAME);
     id_arr.back().id.bwGlb.seg = seg;
     id_arr.back().id.bwGlb.off = off;
     id_arr.back().id.bwGlb.regi = regi;
-    return id_arr.size() - 1;
+    return indexLast();
 }
 
 
@@ -176,34 +224,22 @@ int LOCAL_ID::newLongReg(hlType t, const LONGID_TYPE &longT, iICODE ix_)
     eReg regH,regL;
     regL = longT.l();
     regH = longT.h();
-    size_t idx;
     //iICODE ix_;
-    /* Check for entry in the table */
-    for (idx = 0; idx < id_arr.size(); idx++)
+    /* Check for entry in the table, not checking type */
+    auto found = m_byLongReg.find(pairKey(regH, regL));
+    if (found != m_byLongReg.end())
     {
-        ID &entry(id_arr[idx]);
-        if(not entry.isLongRegisterPair())
-            continue;
-        if (/*(locSym->id[idx].type == t) and   Not checking type */
-                (entry.longId().h() == regH) and
-                (entry.longId().l() == regL))
-        {
-            /* Check for occurrence in the list */
-            if (entry.idx.inList(ix_))
-                return idx;
-            else
-            {
-                /* Insert icode index in list */
-                entry.idx.push_back(ix_);
-                return idx;
-            }
-        }
+        ID &entry(id_arr[found->second]);
+        /* Check for occurrence in the list */
+        if (not entry.idx.inList(ix_))
+            entry.idx.push_back(ix_); /* Insert icode index in list */
+        return found->second;
     }
 
     /* Not in the table, create new identifier */
     id_arr.emplace_back(t, LONGID_TYPE(regH,regL));
     id_arr.back().idx.push_back(ix_);
-    return (id_arr.size() - 1);
+    return indexLast();
 }
 /** \returns an identifier conditional expression node of type TYPE_LONG or TYPE_WORD_SIGN	*/
 AstIdent * LOCAL_ID::createId(const ID *retVal, iICODE ix_)
@@ -216,21 +252,14 @@ AstIdent * LOCAL_ID::createId(const ID *retVal, iICODE ix_)
  * TYPE_LONG_(UN)SIGN and returns the index to this new entry.  */
 int LOCAL_ID::newLongGlb(int16_t seg, int16_t offH, int16_t offL,hlType t)
 {
-    size_t idx;
-
-    /* Check for entry in the table */
-    for (idx = 0; idx < id_arr.size(); idx++)
-    {
-        if (/*(locSym->id[idx].type == t) and   Not checking type */
-                (id_arr[idx].id.longGlb.seg == seg) and
-                (id_arr[idx].id.longGlb.offH == offH) and
-                (id_arr[idx].id.longGlb.offL == offL))
-            return (idx);
-    }
+    /* Check for entry in the table, not checking type */
+    auto found = m_byLongGlb.find(longGlbKey(seg, offH, offL));
+    if (found != m_byLongGlb.end())
+        return found->second;
     printf("%d",t);
     /* Not in the table, create new identifier */
     id_arr.emplace_back(t, LONGGLB_TYPE(seg,offH,offL));
-    return id_arr.size() - 1;
+    return indexLast();
 
 }
 
@@ -240,20 +269,14 @@ int LOCAL_ID::newLongGlb(int16_t seg, int16_t offH, int16_t offL,hlType t)
  * TYPE_LONG_(UN)SIGN and returns the index to this new entry.  */
 int LOCAL_ID::newLongIdx( int16_t seg, int16_t offH, int16_t offL,uint8_t regi, hlType t)
 {
-    /* Check for entry in the table */
-    for (size_t idx = 0; idx < id_arr.size(); idx++)
-    {
-        if (/*(locSym->id[idx].type == t) and   Not checking type */
-                (id_arr[idx].id.longGlb.seg == seg) and
-                (id_arr[idx].id.longGlb.offH == offH) and
-                (id_arr[idx].id.longGlb.offL == offL) and
-                (id_arr[idx].id.longGlb.regi == regi))
-            return (idx);
-    }
+    /* Check for entry in the table, not checking type */
+    auto found = m_byLongIdx.find(longGlbKey(seg, offH, offL, regi));
+    if (found != m_byLongIdx.end())
+        return found->second;
 
     /* Not in the table, create new identifier */
     id_arr.emplace_back(t,LONGGLB_TYPE(seg,offH,offL,regi));
-    return id_arr.size() - 1;
+    return indexLast();
 }
 
 
@@ -261,18 +284,10 @@ int LOCAL_ID::newLongIdx( int16_t seg, int16_t offH, int16_t offL,uint8_t regi,
  * Returns the index to this entry. */
 int LOCAL_ID::newLongStk(hlType t, int offH, int offL)
 {
-    size_t idx;
-
     /* Check for entry in the table */
-    for (idx = 0; idx < id_arr.size(); idx++)
-    {
-        if(id_arr[idx].loc!=STK_FRAME)
-            continue;
-        if ((id_arr[idx].type == t) and
-                (id_arr[idx].longStkId().offH == offH) and
-                (id_arr[idx].longStkId().offL == offL))
-            return (idx);
-    }
+    auto found = m_byLongStk.find(longStkKey(t, offH, offL));
+    if (found != m_byLongStk.end())
+        return found->second;
 
     /* Not in the table; flag as invalid offH and offL */
     flagByteWordId (offH);
@@ -280,7 +295,7 @@ int LOCAL_ID::newLongStk(hlType t, int offH, int offL)
 
     /* Create new identifier */
     id_arr.emplace_back(t,LONG_STKID_TYPE(offH,offL));
-    return (id_arr.size() - 1);
+    return indexLast();
 }
 
 
@@ -24,7 +24,7 @@ static void     setBits(int16_t type, uint32_t start, uint32_t len);
 static void     process_MOV(LLInst &ll, STATE * pstate);
 static SYM *     lookupAddr (LLOperand *pm, STATE * pstate, int size, uint16_t duFlag);
 void    interactDis(Function * initProc, int ic);
-extern uint32_t    SynthLab;
+extern thread_local uint32_t SynthLab;
 
 
 /* Returns the size of the string pointed by sym and delimited by delim.
@@ -112,32 +112,148 @@ ICODE *Function::translate_XCHG(LLInst *ll,ICODE &_Icode)
     return Icode.addIcode(&eIcode);
 }
 
+/* One activation of the parser: a procedure followed from a machine state,
+ * and, while another path it led to is being followed, what it does once
+ * that path is done */
+struct ParseFrame
+{
+    enum eWait
+    {
+        WAIT_NONE = 0,
+        WAIT_BRANCH,        /* Fall through path of a conditional jump  */
+        WAIT_CASE,          /* Path of a case entry of a switch jump     */
+        WAIT_CALL           /* The called procedure                     */
+    };
+    Function *  proc;
+    STATE *     pstate;     /* own, or the caller's state when following a call */
+    STATE       own;
+    bool        started = false;
+    bool        done = false;
+    eErrorId    err = NO_ERR;
+    eWait       wait = WAIT_NONE;
+    ICODE *     jump = nullptr;     /* The jump or call waiting            */
+    /* WAIT_BRANCH */
+    int         jumpIdx = 0;        /* Index of the conditional jump       */
+    ICODE *     prev = nullptr;     /* Icode before the conditional jump   */
+    bool        fBranch = false;
+    /* WAIT_CASE */
+    std::vector<uint32_t> caseTargets;
+    size_t      caseIdx = 0;        /* Entry being followed                */
+    size_t      lastBefore = 0;     /* Last icode before its path          */
+    /* WAIT_CALL */
+    STATE       callerState;
+    Function *  callee = nullptr;
+};
+
+/* The activations of the parser still to finish, innermost last.  Following
+ * a path pushes a frame instead of recursing, so the depth of the parsed
+ * code does not use up the native stack; frames are processed in the order
+ * the recursive parser used, so icodes and procedures come out the same. */
+class ParseWorklist
+{
+public:
+    explicit        ParseWorklist(CALL_GRAPH *callGraph) : m_callGraph(callGraph) {}
+    CALL_GRAPH *    callGraph() const { return m_callGraph; }
+    bool            empty() const { return m_frames.empty(); }
+    ParseFrame &    current() { return m_frames.back(); }
+    void            pop() { m_frames.pop_back(); }
+    /* Follows proc from a copy of state */
+    void            follow(Function *proc, const STATE &state)
+    {
+        m_frames.emplace_back();
+        m_frames.back().proc = proc;
+        m_frames.back().own = state;
+        m_frames.back().pstate = &m_frames.back().own;
+    }
+    /* Follows proc from state itself, which it leaves as it ends */
+    void            followShared(Function *proc, STATE *state)
+    {
+        m_frames.emplace_back();
+        m_frames.back().proc = proc;
+        m_frames.back().pstate = state;
+    }
+    /* Follows each of the targets from the current state in turn; the
+     * current frame tags the first icode of each path as a case of jump */
+    void            followCases(ICODE &jump, std::vector<uint32_t> &&targets)
+    {
+        if (targets.empty())
+            return;
+        ParseFrame &frame(current());
+        frame.wait = ParseFrame::WAIT_CASE;
+        frame.jump = &jump;
+        frame.caseTargets = std::move(targets);
+        frame.caseIdx = 0;
+        followCase(frame);
+    }
+    void            followCase(ParseFrame &frame)
+    {
+        frame.lastBefore = frame.proc->Icode.size() - 1;
+        STATE st(*frame.pstate);
+        st.IP = frame.caseTargets[frame.caseIdx];
+        follow(frame.proc, st);
+    }
+private:
+    CALL_GRAPH *    m_callGraph;
+    std::deque<ParseFrame> m_frames;    /* A deque does not move its elements */
+};
+
 /** FollowCtrl - Given an initial procedure, state information and symbol table
  * builds a list of procedures reachable from the initial procedure
  * using a depth first search.     */
 void Function::FollowCtrl(CALL_GRAPH * pcallGraph, STATE *pstate)
+{
+    ParseWorklist work(pcallGraph);
+    work.followShared(this, pstate);
+    while (not work.empty())
+    {
+        ParseFrame &frame(work.current());
+        bool finished;
+        {
+            PhaseTimer timer(PH_PARSE, frame.proc);
+            finished = frame.proc->parseFrame(work, frame);
+        }
+        if (not finished)
+            continue;
+        work.pop();
+        if (not work.empty())
+        {
+            ParseFrame &outer(work.current());
+            PhaseTimer timer(PH_PARSE, outer.proc);
+            outer.proc->resumeFrame(work, outer);
+        }
+    }
+}
+
+/* Parses straight line code from the frame's state until the path ends, or
+ * until another path has to be followed first.  Returns true at the end of
+ * the path. */
+bool Function::parseFrame(ParseWorklist &work, ParseFrame &frame)
 {
     PROG &prog(Project::get()->prog);
+    STATE *pstate = frame.pstate;
     ICODE   _Icode, *pIcode;     /* This gets copied to pProc->Icode[] later */
     SYM *    psym;
     uint32_t   offset;
-    eErrorId err;
-    bool   done = false;
+    eErrorId &err(frame.err);
+    bool   &done(frame.done);
     SYMTAB &global_symbol_table(Project::get()->symtab);
-    if (name.contains("chkstk"))
+    if (not frame.started)
     {
-        // Danger! Dcc will likely fall over in this code.
-        // So we act as though we have done with this proc
-        //		pProc->flg &= ~TERMINATES;			// Not sure about this
-        // And mark it as a library function, so structure() won't choke on it
-        flg |= PROC_ISLIB;
-        return;
-    }
-    if (option.VeryVerbose)
-    {
-        qDebug() << "Parsing proc" << name << "at" << QString::number(pstate->IP,16).toUpper();
+        frame.started = true;
+        if (name.contains("chkstk"))
+        {
+            // Danger! Dcc will likely fall over in this code.
+            // So we act as though we have done with this proc
+            //		pProc->flg &= ~TERMINATES;			// Not sure about this
+            // And mark it as a library function, so structure() won't choke on it
+            flg |= PROC_ISLIB;
+            return true;
+        }
+        if (option.VeryVerbose)
+        {
+            qDebug() << "Parsing proc" << name << "at" << QString::number(pstate->IP,16).toUpper();
+        }
     }
-
     while (not done )
     {
         err = scan(pstate->IP, _Icode);
@@ -180,8 +296,6 @@ void Function::FollowCtrl(CALL_GRAPH * pcallGraph, STATE *pstate)
             case iJO:   case iJNO:      case iJP:   case iJNP:
             case iJCXZ:
             {
-                STATE   StCopy;
-                uint32_t  lastIp = pstate->IP - 2;
                 int     ip      = Icode.size()-1;	/* Index of this jump */
                 ICODE  &prev(*(++Icode.rbegin())); /* Previous icode */
                 bool   fBranch = false;
@@ -200,32 +314,28 @@ void Function::FollowCtrl(CALL_GRAPH * pcallGraph, STATE *pstate)
                         pstate->JCond.regi = prev.ll()->m_dst.regi;
                     fBranch = (bool) (ll->getOpcode() == iJB or ll->getOpcode() == iJBE);
                 }
-                StCopy = *pstate;
-
-                //printf("From %X condJump to %X\n", lastIp, pstate->IP);
 
-                /* Straight line code */
-                this->FollowCtrl (pcallGraph, &StCopy); // recurrent ?
-
-                if (fBranch)                /* Do branching code */
-                {
-                    pstate->JCond.regi = prev.ll()->m_dst.regi;
-                }
-                /* Next icode. Note: not the same as GetLastIcode() because of the call
-                                to FollowCtrl() */
-                pIcode = Icode.GetIcode(ip);
-            }		/* Fall through to do the jump path */
+                /* Straight line code first, then the jump path (resumeFrame) */
+                frame.wait = ParseFrame::WAIT_BRANCH;
+                frame.jumpIdx = ip;
+                frame.prev = &prev;
+                frame.fBranch = fBranch;
+                work.follow(this, *pstate);
+                return false;
+            }
 
                 /*** Jumps ***/
             case iJMP:
             case iJMPF: /* Returns true if we've run into a loop */
-                done = process_JMP (*pIcode, pstate, pcallGraph);
+                done = process_JMP (*pIcode, pstate, work);
                 break;
 
                 /*** Calls ***/
             case iCALL:
             case iCALLF:
-                done = process_CALL (*pIcode, pcallGraph, pstate);
+                done = process_CALL (*pIcode, work, pstate);
+                if (frame.wait == ParseFrame::WAIT_CALL)
+                    return false;
                 pstate->kill(rBX);
                 pstate->kill(rCX);
                 break;
@@ -313,6 +423,8 @@ void Function::FollowCtrl(CALL_GRAPH * pcallGraph, STATE *pstate)
                 }
                 break;
         }
+        if (frame.wait != ParseFrame::WAIT_NONE)    /* Switch cases to follow */
+            return false;
     }
 
     if (err) {
@@ -328,6 +440,56 @@ void Function::FollowCtrl(CALL_GRAPH * pcallGraph, STATE *pstate)
         else
             reportError(err, _Icode.ll()->label);
     }
+    return true;
+}
+
+/* Carries on with the frame once the path it was waiting for is done */
+void Function::resumeFrame(ParseWorklist &work, ParseFrame &frame)
+{
+    STATE *pstate = frame.pstate;
+    ParseFrame::eWait wait = frame.wait;
+    frame.wait = ParseFrame::WAIT_NONE;
+    switch (wait)
+    {
+        case ParseFrame::WAIT_BRANCH:
+            if (frame.fBranch)                /* Do branching code */
+            {
+                pstate->JCond.regi = frame.prev->ll()->m_dst.regi;
+            }
+            /* Next icode. Note: not the same as GetLastIcode() because of the
+             * straight line code parsed since */
+            frame.done = process_JMP (*Icode.GetIcode(frame.jumpIdx), pstate, work);
+            break;
+
+        case ParseFrame::WAIT_CASE:
+        {
+            ICODE &first(Icode[frame.lastBefore+1]); /* First icode of the case's path */
+            first.ll()->caseEntry = frame.caseIdx;
+            first.ll()->setFlags(CASE);
+            frame.jump->ll()->caseTbl2.push_back( first.ll()->GetLlLabel() );
+            if (++frame.caseIdx < frame.caseTargets.size())
+            {
+                frame.wait = ParseFrame::WAIT_CASE;
+                work.followCase(frame);
+            }
+            break;
+        }
+
+        case ParseFrame::WAIT_CALL:
+            /* Restore segment registers & IP from the caller's state */
+            pstate->IP = frame.callerState.IP;
+            pstate->setState( rCS, frame.callerState.r[rCS]);
+            pstate->setState( rDS, frame.callerState.r[rDS]);
+            pstate->setState( rES, frame.callerState.r[rES]);
+            pstate->setState( rSS, frame.callerState.r[rSS]);
+            frame.jump->ll()->src().proc.proc = frame.callee; // ^ target proc
+            pstate->kill(rBX);
+            pstate->kill(rCX);
+            break;
+
+        case ParseFrame::WAIT_NONE:
+            break;
+    }
 }
 
 /* Firstly look for a leading range check of the form:-
@@ -346,33 +508,22 @@ void Function::extractJumpTableRange(ICODE& pIcode, STATE *pstate, JumpTable &ta
 }
 
 /* process_JMP - Handles JMPs, returns true if we should end recursion  */
-bool Function::followAllTableEntries(JumpTable &table, uint32_t cs, ICODE& pIcode, CALL_GRAPH* pcallGraph, STATE *pstate)
+bool Function::followAllTableEntries(JumpTable &table, uint32_t cs, ICODE& pIcode, ParseWorklist &work, STATE *pstate)
 {
     PROG &prog(Project::get()->prog);
-    STATE   StCopy;
+    std::vector<uint32_t> targets;
 
     setBits(BM_DATA, table.start, table.size()*table.entrySize());
 
     pIcode.ll()->setFlags(SWITCH);
     pIcode.ll()->caseTbl2.resize( table.size() );
     assert(pIcode.ll()->caseTbl2.size()<512);
-    uint32_t k=0;
     for (size_t i = table.start; i < table.finish; i += 2)
-    {
-        StCopy = *pstate;
-        StCopy.IP = cs + LH(&prog.image()[i]);
-        iICODE last_current_insn = (++Icode.rbegin()).base();
-
-        FollowCtrl (pcallGraph, &StCopy);
-
-        ++last_current_insn; // incremented here because FollowCtrl might have adde more instructions after the Jmp
-        last_current_insn->ll()->caseEntry = k++;
-        last_current_insn->ll()->setFlags(CASE);
-        pIcode.ll()->caseTbl2.push_back( last_current_insn->ll()->GetLlLabel() );
-    }
+        targets.push_back(cs + LH(&prog.image()[i]));
+    work.followCases(pIcode, std::move(targets));
     return true;
 }
-bool Function::decodeIndirectJMP(ICODE & pIcode, STATE *pstate, CALL_GRAPH * pcallGraph)
+bool Function::decodeIndirectJMP(ICODE & pIcode, STATE *pstate, ParseWorklist &work)
 {
     PROG &prog(Project::get()->prog);
 //    mov cx,NUM_CASES
@@ -445,20 +596,15 @@ bool Function::decodeIndirectJMP(ICODE & pIcode, STATE *pstate, CALL_GRAPH * pca
     setBits(BM_DATA, table_addr, num_cases*2 + num_cases*2); // num_cases of short values + num cases short ptrs
     pIcode.ll()->setFlags(SWITCH);
 
+    std::vector<uint32_t> targets;
     for(int i=0; i<num_cases; ++i) {
-        STATE   StCopy = *pstate;
         uint32_t jump_target_location = table_addr + num_cases*2 + i*2;
-        StCopy.IP = cs + *(uint16_t *)(prog.image()+jump_target_location);
-        iICODE last_current_insn = (++Icode.rbegin()).base();
-        FollowCtrl (pcallGraph, &StCopy);
-        ++last_current_insn;
-        last_current_insn->ll()->caseEntry = i;
-        last_current_insn->ll()->setFlags(CASE);
-        pIcode.ll()->caseTbl2.push_back( last_current_insn->ll()->GetLlLabel() );
+        targets.push_back(cs + *(uint16_t *)(prog.image()+jump_target_location));
     }
+    work.followCases(pIcode, std::move(targets));
     return true;
 }
-bool Function::decodeIndirectJMP2(ICODE & pIcode, STATE *pstate, CALL_GRAPH * pcallGraph)
+bool Function::decodeIndirectJMP2(ICODE & pIcode, STATE *pstate, ParseWorklist &work)
 {
     PROG &prog(Project::get()->prog);
 //    mov cx,NUM_CASES
@@ -531,28 +677,23 @@ bool Function::decodeIndirectJMP2(ICODE & pIcode, STATE *pstate, CALL_GRAPH * pc
     setBits(BM_DATA, table_addr, num_cases*4 + num_cases*2); // num_cases of long values + num cases short ptrs
     pIcode.ll()->setFlags(SWITCH);
 
+    std::vector<uint32_t> targets;
     for(int i=0; i<num_cases; ++i) {
-        STATE   StCopy = *pstate;
         uint32_t jump_target_location = table_addr + num_cases*4 + i*2;
-        StCopy.IP = cs + *(uint16_t *)(prog.image()+jump_target_location);
-        iICODE last_current_insn = (++Icode.rbegin()).base();
-        FollowCtrl (pcallGraph, &StCopy);
-        ++last_current_insn;
-        last_current_insn->ll()->caseEntry = i;
-        last_current_insn->ll()->setFlags(CASE);
-        pIcode.ll()->caseTbl2.push_back( last_current_insn->ll()->GetLlLabel() );
+        targets.push_back(cs + *(uint16_t *)(prog.image()+jump_target_location));
     }
+    work.followCases(pIcode, std::move(targets));
     return true;
 }
 
-bool Function::process_JMP (ICODE & pIcode, STATE *pstate, CALL_GRAPH * pcallGraph)
+bool Function::process_JMP (ICODE & pIcode, STATE *pstate, ParseWorklist &work)
 {
     PROG &prog(Project::get()->prog);
     static uint8_t i2r[4] = {rSI, rDI, rBP, rBX};
     ICODE       _Icode;
     uint32_t     lastIp = pstate->IP - 1;
     uint32_t       cs, offTable, endTable;
-    uint32_t       i, k, seg, target;
+    uint32_t       i, seg, target;
 
     if (pIcode.ll()->testFlags(I))
     {
@@ -633,41 +774,28 @@ bool Function::process_JMP (ICODE & pIcode, STATE *pstate, CALL_GRAPH * pcallGra
                 endTable = i;
         }
 
-        /* Now for each entry in the table take a copy of the current
-         * state and recursively call FollowCtrl(). */
+        /* Now each entry in the table is followed from a copy of the
+         * current state. */
         if (offTable < endTable)
         {
             assert(((endTable - offTable) / 2)<512);
-            STATE   StCopy;
-            //int     ip;
-            //uint32_t  *psw;
+            std::vector<uint32_t> targets;
 
             setBits(BM_DATA, offTable, endTable - offTable);
 
             pIcode.ll()->setFlags(SWITCH);
             //pIcode.ll()->caseTbl2.numEntries = (endTable - offTable) / 2;
 
-            for (i = offTable, k = 0; i < endTable; i += 2)
-            {
-                StCopy = *pstate;
-                StCopy.IP = cs + LH(&prog.image()[i]);
-                iICODE last_current_insn = (++Icode.rbegin()).base();
-                //ip = Icode.size();
-
-                FollowCtrl (pcallGraph, &StCopy);
-                ++last_current_insn;
-                last_current_insn->ll()->caseEntry = k++;
-                last_current_insn->ll()->setFlags(CASE);
-                pIcode.ll()->caseTbl2.push_back( last_current_insn->ll()->GetLlLabel() );
-
-            }
+            for (i = offTable; i < endTable; i += 2)
+                targets.push_back(cs + LH(&prog.image()[i]));
+            work.followCases(pIcode, std::move(targets));
             return true;
         }
     }
-    if(decodeIndirectJMP(pIcode,pstate,pcallGraph)) {
+    if(decodeIndirectJMP(pIcode,pstate,work)) {
         return true;
     }
-    if(decodeIndirectJMP2(pIcode,pstate,pcallGraph)) {
+    if(decodeIndirectJMP2(pIcode,pstate,work)) {
         return true;
     }
 
@@ -689,11 +817,11 @@ bool Function::process_JMP (ICODE & pIcode, STATE *pstate, CALL_GRAPH * pcallGra
  *       programmer expected it to come back - otherwise surely a JMP would
  *       have been used.  */
 
-bool Function::process_CALL(ICODE & pIcode, CALL_GRAPH * pcallGraph, STATE *pstate)
+bool Function::process_CALL(ICODE & pIcode, ParseWorklist &work, STATE *pstate)
 {
     PROG &prog(Project::get()->prog);
+    CALL_GRAPH *pcallGraph = work.callGraph();
     ICODE &last_insn(Icode.back());
-    STATE localState;     /* Local copy of the machine state */
     uint32_t     lastIp = pstate->IP - 2;
     uint32_t off;
     /* For Indirect Calls, find the function address */
@@ -759,9 +887,8 @@ bool Function::process_CALL(ICODE & pIcode, CALL_GRAPH * pcallGraph, STATE *psta
         /* Create a new procedure node and save copy of the state */
         if ( not Project::get()->valid(iter) )
         {
-            iter = Project::get()->createFunction(0,"");
+            iter = Project::get()->createFunction(0,"",pIcode.ll()->src().getImm2());
             Function &x(*iter);
-            x.procEntry = pIcode.ll()->src().getImm2();
             LibCheck(x);
 
             if (x.flg & PROC_ISLIB)
@@ -783,8 +910,9 @@ bool Function::process_CALL(ICODE & pIcode, CALL_GRAPH * pcallGraph, STATE *psta
             x.depth = x.depth + 1;
             x.flg |= TERMINATES;
 
-            /* Save machine state in localState, load up IP and CS.*/
-            localState = *pstate;
+            /* Save machine state in the caller's frame, load up IP and CS.*/
+            ParseFrame &frame(work.current());
+            frame.callerState = *pstate;
             pstate->IP = pIcode.ll()->src().getImm2();
             if (pIcode.ll()->getOpcode() == iCALLF)
                 pstate->setState( rCS, LH(prog.image() + pIcode.ll()->label + 3));
@@ -796,16 +924,13 @@ bool Function::process_CALL(ICODE & pIcode, CALL_GRAPH * pcallGraph, STATE *psta
 
             //printf("From %X CALL to %X\n", lastIp, pstate->IP);
 
-            /* Process new procedure */
-            x.FollowCtrl (pcallGraph, pstate);
-
-            /* Restore segment registers & IP from localState */
-            pstate->IP = localState.IP;
-            pstate->setState( rCS, localState.r[rCS]);
-            pstate->setState( rDS, localState.r[rDS]);
-            pstate->setState( rES, localState.r[rES]);
-            pstate->setState( rSS, localState.r[rSS]);
-
+            /* Process new procedure; the caller's state is restored and the
+             * call bound to it once it is done (resumeFrame) */
+            frame.wait = ParseFrame::WAIT_CALL;
+            frame.jump = &last_insn;
+            frame.callee = &x;
+            work.followShared(&x, pstate);
+            return false;
         }
         else
             Project::get()->callGraph->insertCallGraph (this, iter);
@@ -944,7 +1069,6 @@ void STKFRAME::updateFrameOff ( int16_t off, int _size, uint16_t duFlag)
 static SYM * lookupAddr (LLOperand *pm, STATE *pstate, int size, uint16_t duFlag)
 {
     PROG &prog(Project::get()->prog);
-    int     i;
     SYM *    psym=nullptr;
     uint32_t   operand;
     bool created_new=false;
@@ -968,11 +1092,8 @@ static SYM * lookupAddr (LLOperand *pm, STATE *pstate, int size, uint16_t duFlag
         {
             if (size == 4)
                 operand += 2;   /* High uint16_t */
-            for (i = 0; i < prog.cReloc; i++)
-                if (prog.relocTable[i] == operand) {
-                    psym->flg = SEG_IMMED;
-                    break;
-                }
+            if (prog.isRelocated(operand))
+                psym->flg = SEG_IMMED;
         }
     }
     /* Check for out of bounds */
@@ -13,6 +13,7 @@
 #include <QtCore/QDebug>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 
 extern Project g_proj;
 /* Static indentation buffer */
@@ -26,50 +27,51 @@ const char *indentStr(int indLevel) // Indentation according to the depth of the
 }
 
 
-/* Inserts an outEdge at the current callGraph pointer if the newProc does
- * not exist.  */
-void CALL_GRAPH::insertArc (ilFunction newProc)
+CALL_GRAPH::CALL_GRAPH(ilFunction root)
 {
+    addNode(root, -1);
+}
 
-
-    /* Check if procedure already exists */
-    auto res=std::find_if(outEdges.begin(),outEdges.end(),[newProc](CALL_GRAPH *e) {return e->proc==newProc;});
-    if(res!=outEdges.end())
-        return;
-    /* Include new arc */
-    CALL_GRAPH *pcg = new CALL_GRAPH;
-    pcg->proc = newProc;
-    outEdges.push_back(pcg);
+/* Appends the node of proc, discovered by a call from node creator */
+int CALL_GRAPH::addNode(ilFunction proc, int creator)
+{
+    nodes.push_back(Node{proc, {}, creator});
+    m_nodeOf.emplace(&(*proc), int(nodes.size()-1));
+    return int(nodes.size()-1);
 }
 
 
-/* Inserts a (caller, callee) arc in the call graph tree. */
+/* Inserts a (caller, callee) arc in the call graph, if not there yet.
+ * Returns false if the caller is not in the graph. */
 bool CALL_GRAPH::insertCallGraph(ilFunction caller, ilFunction callee)
 {
-    if (proc == caller)
-    {
-        insertArc (callee);
-        return true;
-    }
-        for (CALL_GRAPH *edg : outEdges)
-            if (edg->insertCallGraph (caller, callee))
-                return true;
-    return false;
+    return insertCallGraph(&(*caller), callee);
 }
 
 bool CALL_GRAPH::insertCallGraph(Function *caller, ilFunction callee)
 {
-    return insertCallGraph(Project::get()->funcIter(caller),callee);
+    auto from = m_nodeOf.find(caller);
+    if (from == m_nodeOf.end())
+        return false;
+    int callerNode = from->second;
+    auto to = m_nodeOf.find(&(*callee));
+    int calleeNode = (to != m_nodeOf.end()) ? to->second : addNode(callee, callerNode);
+    /* Check if the arc already exists */
+    if (m_arcs.insert((uint64_t(callerNode) << 32) | uint32_t(calleeNode)).second)
+        nodes[callerNode].outEdges.push_back(calleeNode);
+    return true;
 }
 
 
 /* Displays the current node of the call graph, and invokes recursively on
  * the nodes the procedure invokes. */
-void CALL_GRAPH::writeNodeCallGraph(int indIdx)
+void CALL_GRAPH::writeNodeCallGraph(int node, int indIdx, bool expand)
 {
-    qDebug() << indentStr(indIdx)+proc->name;
-    for (CALL_GRAPH *cg : outEdges)
-        cg->writeNodeCallGraph (indIdx + 1);
+    qDebug() << indentStr(indIdx)+nodes[node].proc->name;
+    if (not expand)
+        return;
+    for (int callee : nodes[node].outEdges)
+        writeNodeCallGraph (callee, indIdx + 1, expands(node, callee));
 }
 
 
@@ -77,7 +79,67 @@ void CALL_GRAPH::writeNodeCallGraph(int indIdx)
 void CALL_GRAPH::write()
 {
     printf ("\nCall Graph:\n");
-    writeNodeCallGraph (0);
+    writeNodeCallGraph (0, 0, true);
+}
+
+
+/* Tarjan's algorithm, with an explicit stack so that deep call chains do
+ * not overflow the native one.  Components are completed callees first. */
+std::vector<std::vector<Function *> > CALL_GRAPH::bottomUpSCCs() const
+{
+    const int numNodes = int(nodes.size());
+    std::vector<int> index(numNodes, -1), lowLink(numNodes, 0);
+    std::vector<bool> onStack(numNodes, false);
+    std::vector<int> sccStack;
+    std::vector<std::pair<int,size_t> > dfs;    /* Node, next out edge to follow */
+    std::vector<std::vector<Function *> > res;
+    int nextIndex = 0;
+
+    for (int start = 0; start < numNodes; start++)
+    {
+        if (index[start] != -1)
+            continue;
+        dfs.emplace_back(start, 0);
+        while (not dfs.empty())
+        {
+            int v = dfs.back().first;
+            if (dfs.back().second == 0 and index[v] == -1)
+            {
+                index[v] = lowLink[v] = nextIndex++;
+                sccStack.push_back(v);
+                onStack[v] = true;
+            }
+            if (dfs.back().second < nodes[v].outEdges.size())
+            {
+                int w = nodes[v].outEdges[dfs.back().second++];
+                if (index[w] == -1)
+                    dfs.emplace_back(w, 0);
+                else if (onStack[w])
+                    lowLink[v] = std::min(lowLink[v], index[w]);
+                continue;
+            }
+            /* All callees of v done */
+            dfs.pop_back();
+            if (not dfs.empty())
+            {
+                int parent = dfs.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[v]);
+            }
+            if (lowLink[v] == index[v])
+            {
+                res.emplace_back();
+                int w;
+                do
+                {
+                    w = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[w] = false;
+                    res.back().push_back(&(*nodes[w].proc));
+                } while (w != v);
+            }
+        }
+    }
+    return res;
 }
 
 
@@ -170,7 +232,7 @@ void LOCAL_ID::newRegArg(ICODE &picode, ICODE &ticode) const
             if (regL >= rAL)
                 rType = BYTE_REG;
             newsym.type = (regL < rAL) ? TYPE_WORD_SIGN : TYPE_BYTE_SIGN;
-            newsym.regs = new RegisterNode(tidx, rType,this);
+            newsym.regs = RegisterNode::Create(tidx, rType,this);
             tproc->localId.id_arr[tidx].name = newsym.name;
         }
         else if (type == LONG_VAR)
@@ -299,9 +361,6 @@ Expr *Function::adjustActArgType (Expr *_exp, hlType forType)
                         offset = (state.r[rDS]<<4) + offL + 0x100;
                     else
                         offset = (state.r[rDS]<<4) + offL;
-                    expr->ident.idNode.strIdx = offset;
-                    expr->ident.type(STRING);
-                    delete c;
                     return AstIdent::String(offset);
                 }
 
@@ -8,17 +8,24 @@
 
 using namespace std;
 
-QString asm1_name, asm2_name;     /* Assembler output filenames     */
-STATS   stats;              /* cfg statistics                       */
+thread_local QString asm1_name, asm2_name; /* Assembler output filenames */
+thread_local STATS stats;  /* cfg statistics                       */
 OPTION  option;             /* Command line options                 */
 Project *Project::s_instance = nullptr;
+thread_local Project *Project::s_current = nullptr;
 Project::Project() : callGraph(nullptr)
 {
 }
+Project::~Project()
+{
+    delete callGraph;
+}
 void Project::initialize()
 {
     delete callGraph;
     callGraph = nullptr;
+    decodeCache.clear();
+    labelIdx = 1;
 }
 void Project::create(const QString &a)
 {
@@ -29,6 +36,12 @@ void Project::create(const QString &a)
     m_output_path = fi.path();
 }
 
+/* Number of threads analysing and generating the procedures */
+unsigned Project::procJobs() const
+{
+    return jobs ? jobs : option.Jobs;
+}
+
 QString Project::output_name(const char *ext) {
     return m_output_path+QDir::separator()+m_project_name+"."+ext;
 }
@@ -38,33 +51,40 @@ bool Project::valid(ilFunction iter)
 }
 ilFunction Project::funcIter(Function *to_find)
 {
-    auto iter=std::find_if(pProcList.begin(),pProcList.end(),
-                           [to_find](const Function &f)->bool {return to_find==&f;});
-    assert(iter!=pProcList.end());
-    return iter;
+    auto iter=m_byAddr.find(to_find);
+    assert(iter!=m_byAddr.end());
+    return iter->second;
 }
 
 ilFunction Project::findByEntry(uint32_t entry)
 {
     /* Search procedure list for one with appropriate entry point */
-    ilFunction iter= std::find_if(pProcList.begin(),pProcList.end(),
-                                  [entry](const Function &f)  { return f.procEntry==entry; });
-    return iter;
+    auto iter=m_byEntry.find(entry);
+    if(iter==m_byEntry.end())
+        return pProcList.end();
+    return iter->second;
 }
 
-ilFunction Project::createFunction(FunctionType *f,const QString &name)
+ilFunction Project::createFunction(FunctionType *f,const QString &name,uint32_t entry)
 {
     pProcList.push_back(*Function::Create(f,0,name,0));
-    return (++pProcList.rbegin()).base();
+    ilFunction res = (++pProcList.rbegin()).base();
+    res->procEntry = entry;
+    m_byEntry.emplace(entry,res);       /* The first procedure at entry is the one found */
+    m_byAddr.emplace(&(*res),res);
+    return res;
+}
+
+void Project::clearFunctions()
+{
+    pProcList.clear();
+    m_byEntry.clear();
+    m_byAddr.clear();
 }
 
 int Project::getSymIdxByAddr(uint32_t adr)
 {
-    size_t i;
-    for (i = 0; i < symtab.size(); i++)
-        if (symtab[i].label == adr)
-            break;
-    return i;
+    return symtab.indexOf(adr);
 }
 bool Project::validSymIdx(size_t idx)
 {
@@ -92,11 +112,18 @@ const QString &Project::symbolName(size_t idx)
 }
 Project *Project::get()
 {
+    if(s_current)
+        return s_current;
     //WARNING: poor man's singleton, not thread safe
     if(s_instance==nullptr)
         s_instance=new Project;
     return s_instance;
 }
+void Project::setCurrent(Project *p)
+{
+    Profiler::creditThread(s_current ? s_current : s_instance);
+    s_current = p;
+}
 SourceMachine *Project::machine()
 {
     return nullptr;
@@ -12,7 +12,7 @@
 #include <cstring>
 #include <stdint.h>
 
-static int      numInt;     /* Number of intervals      */
+static thread_local int numInt; /* Number of intervals      */
 
 
 #define nonEmpty(q)     (q != NULL)
@@ -72,8 +72,12 @@ void interval::appendNodeInt(queue &pqH, BB *node)
 {
     queue::iterator pq;        /* Pointer to current node of the list      */
 
-    /* Append node if it is not already in the interval list */
-    pq = appendQueue (nodes, node);
+    /* Append node if it is not already in the interval list; only a node
+     * of this interval can be */
+    if (node->inInterval == this)
+        pq = appendQueue (nodes, node);
+    else
+        pq = nodes.insert(nodes.end(), node);
 
     /* Update currNode if necessary */
     if (currNode == nodes.end())
@@ -110,13 +114,13 @@ void derSeq_Entry::findIntervals (Function *c)
 
     appendQueue (H, Gi);  /* H = {first node of G} */
     Gi->beenOnH = true;
-    Gi->reachingInt = BB::Create(nullptr,"",c); /* ^ empty BB */
+    Gi->reachingInt = BB::Create(nullptr,"",c); /* ^ empty BB, in c's arena */
 
     /* Process header nodes list H */
     while (not H.empty())
     {
         header = firstOfQueue (H);
-        pI = new interval;
+        pI = c->derivedNodes.create<interval>();
         pI->numInt = (uint8_t)numInt++;
         if (first)               /* ^ to first interval  */
         {
@@ -208,34 +212,6 @@ static void displayIntervals (interval *pI)
 //}
 
 
-/* Frees the storage allocated for the interval pI */
-static void freeInterval (interval **pI)
-{
-    interval *Iptr;
-
-    while (*pI)
-    {
-        (*pI)->nodes.clear();
-        Iptr = *pI;
-        *pI = (*pI)->next;
-        delete (Iptr);
-    }
-}
-
-
-/* Frees the storage allocated by the derived sequence structure, except
- * for the original graph cfg (derivedG->Gi).               */
-void freeDerivedSeq(derSeq &derivedG)
-{
-    derivedG.clear();
-}
-derSeq_Entry::~derSeq_Entry()
-{
-    freeInterval (&Ii);
-    //    if(Gi and Gi->nodeType == INTERVAL_NODE)
-    //        freeCFG (Gi);
-}
-
 /* Finds the next order graph of derivedGi->Gi according to its intervals
  * (derivedGi->Ii), and places it in derivedGi->next->Gi.       */
 bool Function::nextOrderGraph (derSeq &derivedGi)
@@ -257,6 +233,7 @@ bool Function::nextOrderGraph (derSeq &derivedGi)
 
         BBnode = BB::CreateIntervalBB(this);
         BBnode->correspInt = Ii;
+        Ii->derivedBB = BBnode;
         bbs.push_back(BBnode);
         const queue &listIi(Ii->nodes);
 
@@ -264,10 +241,17 @@ bool Function::nextOrderGraph (derSeq &derivedGi)
         if (sameGraph and (listIi.size()>1))
             sameGraph = false;
 
-        /* Find out edges */
+        /* Find out edges, counting them first so that each BB's edges are
+         * allocated once */
 
         if (Ii->numOutEdges <= 0)
             continue;
+        size_t numOutEdges = 0;
+        for(BB *curr :  listIi)
+            for (const TYPEADR_TYPE &edge : curr->edges)
+                if (edge.BBptr->inInterval != curr->inInterval)
+                    numOutEdges++;
+        BBnode->edges.reserve(numOutEdges);
         for(BB *curr :  listIi)
         {
             for (size_t j = 0; j < curr->edges.size(); j++)
@@ -288,16 +272,15 @@ bool Function::nextOrderGraph (derSeq &derivedGi)
     {
         for(TYPEADR_TYPE &edge : curr->edges)
         {
-            BBnode = new_entry.Gi;    /* BB of an interval */
-            auto iter= std::find_if(bbs.begin(),bbs.end(),
-                                    [&edge](BB *node)->bool { return edge.intPtr==node->correspInt;});
-            if(iter==bbs.end())
+            BBnode = edge.intPtr->derivedBB;    /* BB of an interval */
+            if (BBnode == nullptr)
                 fatalError (INVALID_INT_BB);
-            edge.BBptr = *iter;
-            (*iter)->inEdges.push_back((BB *)nullptr);
-            (*iter)->inEdgeCount++;
+            edge.BBptr = BBnode;
+            BBnode->inEdgeCount++;
         }
     }
+    for(BB *curr : bbs)
+        curr->inEdges.assign(curr->inEdgeCount, (BB *)nullptr);
     return not sameGraph;
 }
 
@@ -354,7 +337,8 @@ void derSeq::display()
 /* Checks whether the control flow graph, cfg, is reducible or not.
  * If it is not reducible, it is converted into an equivalent reducible
  * graph by node splitting.  The derived sequence of graphs built from cfg
- * are returned in the pointer *derivedG.
+ * are returned in the pointer *derivedG.  It, its intervals and the BBs
+ * of its graphs live in derivedNodes, until that is released.
  */
 derSeq * Function::checkReducibility()
 {
@@ -363,7 +347,7 @@ derSeq * Function::checkReducibility()
 
     numInt = 1;         /* reinitialize no. of intervals*/
     stats.nOrder = 1;   /* nOrder(cfg) = 1      */
-    der_seq = new derSeq;
+    der_seq = derivedNodes.create<derSeq>();
     der_seq->resize(1);
     der_seq->back().Gi = *m_actual_cfg.begin(); /*m_cfg.front()*/;
     reducible = findDerivedSeq(*der_seq);
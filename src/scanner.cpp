@@ -317,9 +317,10 @@ static const StateTabelEntry stateTable[] = {
     {  trans,   none1, NSP                      , iINVALID    }    /* FF */
 } ;
 
-static uint16_t    SegPrefix, RepPrefix;
-static const uint8_t  *pInst;        /* Ptr. to current uint8_t of instruction */
-static ICODE * pIcode;        /* Ptr to Icode record filled in by scan() */
+static thread_local uint16_t    SegPrefix, RepPrefix;
+static thread_local const uint8_t  *pInst;        /* Ptr. to current uint8_t of instruction */
+static thread_local ICODE * pIcode;        /* Ptr to Icode record filled in by scan() */
+static thread_local const x86_insn_t *pInsn; /* Operands come from here, unless decoding the image */
 
 
 static void decodeBranchTgt(x86_insn_t &insn)
@@ -396,6 +397,7 @@ static void fixFloatEmulation(x86_insn_t &insn)
     ds.x86_disasm(buf,actual_valid_bytes,0,1,&patched_insn);
     patched_insn.addr   = insn.addr; // actual address
     patched_insn.offset = insn.offset; // actual offset
+    insn.x86_oplist_free();
     insn = patched_insn;
     insn.size += 1; // to account for emulator call INT
 }
@@ -426,9 +428,13 @@ eReg convertRegister(const x86_reg_t &reg)
                     rAL,rCL,rDL,rBL,
                     rAH,rCH,rDH,rBH
                   };
-    std::map<std::string,eReg> nameToEnum = {{"es",rES},{"ds",rDS},{"cs",rCS},{"ss",rSS}};
-    if(nameToEnum.find(reg.name)!=nameToEnum.end())
-        return nameToEnum[reg.name];
+    static const std::map<std::string,eReg> nameToEnum = {{"es",rES},{"ds",rDS},{"cs",rCS},{"ss",rSS}};
+    if(reg.type & reg_seg)
+    {
+        auto iter = nameToEnum.find(reg.name);
+        if(iter!=nameToEnum.end())
+            return iter->second;
+    }
     assert(reg.id<sizeof(regmap)/sizeof(eReg));
     assert(regmap[reg.id]!=rUNDEF);
     return regmap[reg.id];
@@ -452,10 +458,13 @@ LLOperand convertExpression(const x86_ea_t &from)
     {
         eReg base_reg = convertRegister(from.base);
         eReg index_reg = convertRegister(from.index);
-        //        if(base_reg==rBX)
         switch(base_reg)
         {
+            case rSI:
+                assert(index_reg==rUNDEF);
+                res.regi = INDEX_SI; break;
             case rDI:
+                assert(index_reg==rUNDEF);
                 res.regi = INDEX_DI; break;
             case rBP:
                 res.seg=rSS;
@@ -487,13 +496,8 @@ LLOperand convertExpression(const x86_ea_t &from)
             default:
                 assert(false);
         }
-        assert(index_reg==rUNDEF);
     }
     assert(from.scale==0);
-    if(from.index.id)
-    {
-        assert(false);
-    }
     res.off = from.disp;
     return res;
 }
@@ -511,12 +515,9 @@ LLOperand convertOperand(const x86_op_t &from)
         case op_expression:
             res = convertExpression(from.data.expression); break;
         case op_offset:
-        {
-            LLOperand res;
             res.seg = rDS;
             res.off = from.data.offset;
             break;
-        }
         default:
             fprintf(stderr,"convertOperand does not know how to convert %d\n",from.type);
     }
@@ -529,9 +530,13 @@ LLOperand convertOperand(const x86_op_t &from)
 /*****************************************************************************
  Scans one machine instruction at offset ip in prog.Image and returns error.
  At the same time, fill in low-level icode details for the scanned inst.
+ The instruction is decoded once, by libdisasm; the state table only
+ maps its opcode and modrm bytes to an icode, taking the operands from the
+ x86_insn_t.  With option.LegacyDecode the state table decodes the image
+ itself, which is kept to cross-check the two decoders.
  ****************************************************************************/
 
-eErrorId scan(uint32_t ip, ICODE &p)
+static eErrorId decode(uint32_t ip, ICODE &p)
 {
     PROG &prog(Project::get()->prog);
     int  op;
@@ -551,8 +556,17 @@ eErrorId scan(uint32_t ip, ICODE &p)
     }
 
     SegPrefix = RepPrefix = 0;
-    pInst    = prog.image() + ip;
     pIcode   = &p;
+    pInsn    = nullptr;
+    pInst    = prog.image() + ip;
+    /* LOCK is an instruction of its own to the state table, and float
+     * emulation calls, which fixFloatEmulation rewrote, are left to checkInt */
+    if (cnt and not option.LegacyDecode and not (p.insn.prefix & insn_lock) and
+            p.insn.bytes[0]==*pInst)
+    {
+        pInsn = &p.insn;
+        pInst = p.insn.bytes;
+    }
 
     do
     {
@@ -568,14 +582,17 @@ eErrorId scan(uint32_t ip, ICODE &p)
         if(p.insn.x86_get_branch_target())
             decodeBranchTgt(p.insn);
     }
-    //    LLOperand conv = convertOperand(*p.insn.get_dest());
-    //    assert(conv==p.ll()->dst);
+    /* The icode is filled in, libdisasm's operand list is not needed anymore */
+    p.insn.x86_oplist_free();
     if (p.ll()->getOpcode()!=iINVALID)
     {
         /* Save bytes of image used */
-        p.ll()->numBytes = (uint8_t)((pInst - prog.image()) - ip);
-        if(p.insn.is_valid())
-            assert(p.ll()->numBytes == p.insn.size);
+        if (not pInsn)
+        {
+            p.ll()->numBytes = (uint8_t)((pInst - prog.image()) - ip);
+            if(p.insn.is_valid())
+                assert(p.ll()->numBytes == p.insn.size);
+        }
         p.ll()->numBytes = p.insn.size;
         return ((SegPrefix)? FUNNY_SEGOVR:  /* Seg. Override invalid */
                              (RepPrefix ? FUNNY_REP: NO_ERR));/* REP prefix invalid */
@@ -584,19 +601,38 @@ eErrorId scan(uint32_t ip, ICODE &p)
     return ((stateTable[op].flg & OP386)? INVALID_386OP: INVALID_OPCODE);
 }
 
+/*****************************************************************************
+ Returns the scan of the instruction at offset ip, decoding it only the first
+ time this offset is reached; the decoding depends on nothing but the loaded
+ image, so later visits copy it from the project's decode cache.
+ ****************************************************************************/
+eErrorId scan(uint32_t ip, ICODE &p)
+{
+    Project &proj(*Project::get());
+    if (ip >= (uint32_t)proj.prog.cbImage)
+        return decode(ip, p);
+    const x86_insn_t *insn;
+    eErrorId err;
+    if (const LLInst *ll = proj.decodeCache.find(ip, insn, err))
+    {
+        p = ICODE();
+        p.type = LOW_LEVEL_ICODE;
+        *p.ll() = *ll;
+        p.insn = *insn;
+        return err;
+    }
+    err = decode(ip, p);
+    proj.decodeCache.insert(ip, proj.prog.cbImage, p, err);
+    return err;
+}
+
 /***************************************************************************
  relocItem - returns true if uint16_t pointed at is in relocation table
  **************************************************************************/
 static bool relocItem(const uint8_t *p)
 {
     PROG &prog(Project::get()->prog);
-    int        i;
-    uint32_t    off = p - prog.image();
-
-    for (i = 0; i < prog.cReloc; i++)
-        if (prog.relocTable[i] == off)
-            return true;
-    return false;
+    return prog.isRelocated(uint32_t(p - prog.image()));
 }
 
 
@@ -664,6 +700,26 @@ static void setAddress(int i, bool fdst, uint16_t seg, int16_t reg, uint16_t off
 }
 
 
+/****************************************************************************
+ insnOperand - returns the first (or last) operand of the given type that
+     libdisasm found in the instruction
+ ***************************************************************************/
+static const x86_op_t *insnOperand(x86_op_type type, bool last = false)
+{
+    const x86_op_t *res = nullptr;
+    for (const x86_oplist_t *op = pInsn->operands; op; op = op->next)
+    {
+        if (op->op.type != type)
+            continue;
+        res = &op->op;
+        if (not last)
+            break;
+    }
+    assert(res);
+    return res;
+}
+
+
 /****************************************************************************
  rm - Decodes r/m part of modrm uint8_t for dst (unless TO_REG) part of icode
  ***************************************************************************/
@@ -672,7 +728,15 @@ static void rm(int i)
     uint8_t mod = *pInst >> 6;
     uint8_t rm  = *pInst++ & 7;
 
-    switch (mod) {
+    if (pInsn and mod != 3)
+    {   /* Memory operand, as already decoded by libdisasm */
+        const x86_op_t *ea = insnOperand(op_expression);
+        LLOperand conv = convertExpression(ea->data.expression);
+        setAddress(i, true, SegPrefix, conv.regi, conv.off);
+        if (ea->data.expression.disp_size == 2)
+            pIcode->ll()->setFlags(WORD_OFF);
+    }
+    else switch (mod) {
         case 0:        /* No disp unless rm == 6 */
             if (rm == 6) {
                 setAddress(i, true, SegPrefix, 0, getWord());
@@ -901,7 +965,9 @@ static void arith(int i)
  *****************************************************************************/
 static void data1(int i)
 {
-    pIcode->ll()->replaceSrc(LLOperand::CreateImm2((stateTable[i].flg & S_EXT)? signex(*pInst++): *pInst++,1));
+    /* ENTER has two immediates, the byte one comes last */
+    uint8_t b = pInsn ? insnOperand(op_immediate,true)->data.byte : *pInst++;
+    pIcode->ll()->replaceSrc(LLOperand::CreateImm2((stateTable[i].flg & S_EXT)? signex(b): b,1));
     pIcode->ll()->setFlags(I);
 }
 
@@ -911,7 +977,17 @@ static void data1(int i)
  ****************************************************************************/
 static void data2(int )
 {
-    if (relocItem(pInst))
+    const uint8_t *at = pInst;  /* Image position of the uint16_t */
+    uint16_t w;
+    if (pInsn)
+    {   /* The immediate ends the instruction, except for ENTER's first one */
+        size_t pos = (pIcode->ll()->getOpcode() == iENTER) ? size_t(pInst - pInsn->bytes) : size_t(pInsn->size - 2);
+        at = Project::get()->prog.image() + pInsn->offset + pos;
+        w = insnOperand(op_immediate)->data.word;
+    }
+    else
+        w = getWord();
+    if (relocItem(at))
         pIcode->ll()->setFlags(SEG_IMMED);
 
     /* ENTER is a special case, it does not take a destination operand,
@@ -921,11 +997,11 @@ static void data2(int )
          * set to NO_OPS.    */
     if (pIcode->ll()->getOpcode() == iENTER)
     {
-        pIcode->ll()->m_dst.off = getWord();
+        pIcode->ll()->m_dst.off = w;
         pIcode->ll()->setFlags(NO_OPS);
     }
     else
-        pIcode->ll()->replaceSrc(getWord());
+        pIcode->ll()->replaceSrc(w);
     pIcode->ll()->setFlags(I);
 }
 
@@ -936,7 +1012,8 @@ static void data2(int )
  ****************************************************************************/
 static void dispM(int i)
 {
-    setAddress(i, false, SegPrefix, 0, getWord());
+    uint16_t off = pInsn ? (uint16_t)convertOperand(*insnOperand(op_offset)).off : getWord();
+    setAddress(i, false, SegPrefix, 0, off);
 }
 /****************************************************************************
  dispN - 2 uint8_t disp as immed relative to ip
@@ -970,8 +1047,18 @@ static void dispS(int )
  ***************************************************************************/
 static void dispF(int i)
 {
-    uint16_t off = (unsigned)getWord();
-    uint16_t seg = (unsigned)getWord();
+    uint16_t off,seg;
+    if (pInsn)
+    {
+        const x86_op_t *tgt = insnOperand(op_absolute);
+        off = tgt->data.absolute.offset.off16;
+        seg = tgt->data.absolute.segment;
+    }
+    else
+    {
+        off = (unsigned)getWord();
+        seg = (unsigned)getWord();
+    }
     // FIXME: this is wrong since seg here is seg value, but setAddress treats it as register id
     setAddress(i, true, seg, 0, off);
     //    decodeBranchTgt();
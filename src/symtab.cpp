@@ -32,8 +32,8 @@
 #define STRTABSIZE 256              /* Size string table is inc'd by */
 
 using namespace std;
-static  char *pStrTab;              /* Pointer to the current string table */
-static  int   strTabNext;           /* Next free index into pStrTab */
+static thread_local char *pStrTab;  /* Pointer to the current string table */
+static thread_local int   strTabNext;   /* Next free index into pStrTab */
 namespace std
 {
 template<>
@@ -48,7 +48,7 @@ struct hash<SYMTABLE> : public unary_function<const SYMTABLE &,size_t>
 
 };
 }
-static  tableType curTableType; /* Which table is current */
+static thread_local tableType curTableType; /* Which table is current */
 struct TABLEINFO_TYPE
 {
     TABLEINFO_TYPE()
@@ -68,8 +68,8 @@ private:
     unordered_map<SYMTABLE,string> z2;
 };
 
-static TABLEINFO_TYPE tableInfo[NUM_TABLE_TYPES];   /* Array of info about tables */
-static TABLEINFO_TYPE currentTabInfo;
+static thread_local TABLEINFO_TYPE tableInfo[NUM_TABLE_TYPES];   /* Array of info about tables */
+static thread_local TABLEINFO_TYPE currentTabInfo;
 
 /* Create a new symbol table. Returns "handle" */
 void TABLEINFO_TYPE::create(tableType type)
@@ -184,6 +184,7 @@ SYM * SYMTAB::updateGlobSym (uint32_t operand, int size, uint16_t duFlag,bool &i
     {
         v.duVal.setFlags(duFlag);
     }
+    m_byLabel.emplace(operand, this->size());
     push_back(v);
     inserted_new=true;
     return (&back());
@@ -0,0 +1,121 @@
+#include "bundle.h"
+#include "project.h"
+#include "TaskGraph.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QtCore/QBuffer>
+
+namespace
+{
+/* Writes procCode after the labels of p already written */
+std::string written(Project &p, std::vector<bundle> &procCode)
+{
+    QBuffer buf;
+    buf.open(QBuffer::WriteOnly);
+    Project::setCurrent(&p);
+    for (bundle &b : procCode)
+        writeBundle(buf, b);
+    Project::setCurrent(nullptr);
+    return std::string(buf.data().constData(), size_t(buf.data().size()));
+}
+
+/* Generates procedure i into cCode the way emitGotoLabel does: a loop whose
+ * head is labelled once a goto to it is emitted, and i forward gotos, each
+ * to a label of its own */
+void genProc(int i)
+{
+    cCode.appendDecl("int proc_%d ()\n{\n", i);
+    size_t head = cCode.code.nextIdx();
+    cCode.appendCode("    x = %d;\n", i);
+    std::vector<int> targets;
+    for (int k = 0; k < i; k++)
+    {
+        targets.push_back(cCode.labels++);
+        cCode.code.appendWithLabel("    goto L", targets.back(), ";\n");
+    }
+    int loop = cCode.labels++;
+    cCode.code.addLabelBundle(int(head), loop);
+    cCode.code.appendWithLabel("    goto L", loop, ";\n");
+    for (int target : targets)
+    {
+        size_t idx = cCode.code.nextIdx();
+        cCode.appendCode("    y = %d;\n", target);
+        cCode.code.addLabelBundle(int(idx), target);
+    }
+    cCode.appendCode("}\n");
+}
+}
+
+TEST(LineBuffer, LabelsAreNumberedAcrossTheFile) {
+    Project p;
+    std::vector<bundle> procCode(3);
+    for (int i = 0; i < 2; i++)
+    {
+        bundle &b(procCode[i]);
+        b.code.append("    x = 1;\n", 11);
+        b.code.appendWithLabel("    goto L", 1, ";\n");
+        b.code.appendWithLabel("    goto L", 0, ";\n");
+        b.code.addLabelBundle(0, 0);
+        b.code.append("    y = 2;\n", 11);
+        b.code.addLabelBundle(3, 1);
+        b.labels = 2;
+    }
+    procCode[2].code.append("    return;\n", 12);
+    EXPECT_EQ(std::string("l1: x = 1;\n"
+                         "    goto L2;\n"
+                         "    goto L1;\n"
+                         "l2: y = 2;\n"
+                         "l3: x = 1;\n"
+                         "    goto L4;\n"
+                         "    goto L3;\n"
+                         "l4: y = 2;\n"
+                         "    return;\n"), written(p, procCode));
+    EXPECT_EQ(5, p.labelIdx);
+    for (const bundle &b : procCode)
+        EXPECT_EQ(0u, b.code.nextIdx());
+}
+
+TEST(LineBuffer, BackpatchShiftsLaterRefs) {
+    Project p;
+    p.labelIdx = 5;
+    std::vector<bundle> procCode(1);
+    LineBuffer &code(procCode[0].code);
+    code.append("    x = 1;\n", 11);
+    code.appendWithLabel("    goto L", 0, ";\n");
+    code.appendWithLabel("    goto L", 1, ";\n");
+    code.addLabelBundle(1, 0);      /* Onto the line holding a ref */
+    code.addLabelBundle(0, 1);
+    procCode[0].labels = 2;
+    EXPECT_EQ(std::string("l6: x = 1;\n"
+                         "l5: goto L5;\n"
+                         "    goto L6;\n"), written(p, procCode));
+}
+
+TEST(LineBuffer, ParallelGenerationMatchesSerial) {
+    const int numProcs = 16;
+    Project serial;
+    std::vector<bundle> serialCode(numProcs);
+    for (int i = 0; i < numProcs; i++)
+    {
+        genProc(i);
+        serialCode[i] = std::move(cCode);
+        cCode.init();
+    }
+
+    /* As parallelCodeGen: each task moves its thread's cCode into its slot */
+    Project parallel;
+    std::vector<bundle> parallelCode(numProcs);
+    TaskGraph tasks;
+    for (int i = 0; i < numProcs; i++)
+        tasks.addTask([&parallelCode, i]() {
+            genProc(i);
+            parallelCode[i] = std::move(cCode);
+            cCode.init();
+        });
+    tasks.run(4);
+
+    std::string expected(written(serial, serialCode));
+    EXPECT_EQ(expected, written(parallel, parallelCode));
+    EXPECT_EQ(serial.labelIdx, parallel.labelIdx);
+    EXPECT_EQ(1 + numProcs * (numProcs + 1) / 2, serial.labelIdx);
+}
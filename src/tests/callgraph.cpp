@@ -0,0 +1,51 @@
+#include "project.h"
+#include "CallGraph.h"
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <set>
+
+/* main calls a and c; a and b call each other; d calls itself; b calls the
+ * leaf e and a calls d, so d and e are finished before a and b are */
+TEST(CallGraph, BottomUpSCCsCalleesFirst) {
+    Project p;
+    ilFunction main = p.createFunction(nullptr, "main", 0x100);
+    ilFunction a = p.createFunction(nullptr, "a", 0x200);
+    ilFunction b = p.createFunction(nullptr, "b", 0x300);
+    ilFunction c = p.createFunction(nullptr, "c", 0x400);
+    ilFunction d = p.createFunction(nullptr, "d", 0x500);
+    ilFunction e = p.createFunction(nullptr, "e", 0x600);
+    CALL_GRAPH graph(main);
+    std::vector<std::pair<ilFunction,ilFunction> > calls = {
+        {main, a}, {main, c}, {a, b}, {b, a}, {b, e}, {a, d}, {c, d}, {d, d}
+    };
+    for (const auto &call : calls)
+        ASSERT_TRUE(graph.insertCallGraph(call.first, call.second));
+
+    std::vector<std::vector<Function *> > sccs = graph.bottomUpSCCs();
+    std::map<Function *,size_t> sccOf;
+    std::set<std::set<Function *> > contents;
+    for (size_t i = 0; i < sccs.size(); i++)
+    {
+        for (Function *f : sccs[i])
+            EXPECT_TRUE(sccOf.emplace(f, i).second) << f->name.toStdString() << " is in two components";
+        contents.emplace(sccs[i].begin(), sccs[i].end());
+    }
+    std::set<std::set<Function *> > expected = {
+        {&*main}, {&*a, &*b}, {&*c}, {&*d}, {&*e}
+    };
+    EXPECT_EQ(expected, contents);
+    ASSERT_EQ(6u, sccOf.size());
+
+    /* Every callee outside its caller's component comes first */
+    for (const auto &call : calls)
+    {
+        size_t caller = sccOf[&*call.first], callee = sccOf[&*call.second];
+        if (caller != callee)
+        {
+            EXPECT_LT(callee, caller) << call.first->name.toStdString() << " -> "
+                                      << call.second->name.toStdString();
+        }
+    }
+    EXPECT_EQ(sccs.size() - 1, sccOf[&*main]);
+}
@@ -7,9 +7,11 @@
 #include "dcc.h"
 #include "disassem.h"
 #include "project.h"
+#include "TaskGraph.h"
 
 #include <QtCore/QDebug>
 #include <list>
+#include <unordered_map>
 #include <cassert>
 #include <stdio.h>
 #include <CallGraph.h>
@@ -24,6 +26,8 @@ void Function::buildCFG(Disassembler &ds)
 {
     if(flg & PROC_ISLIB)
         return; // Ignore library functions
+    PhaseTimer timer(PH_BUILD_CFG, this);
+    ExprArena::Scope exprScope(exprs);
     createCFG();
     if (option.VeryVerbose)
         displayCFG();
@@ -46,6 +50,8 @@ void Function::controlFlowAnalysis()
 {
     if (flg & PROC_ISLIB)
         return;         /* Ignore library functions */
+    PhaseTimer timer(PH_CONTROL_FLOW, this);
+    ExprArena::Scope exprScope(exprs);
     derSeq *derivedG=nullptr;
 
     /* Make cfg reducible and build derived sequences */
@@ -67,10 +73,54 @@ void Function::controlFlowAnalysis()
         //m_cfg.front()->displayDfs();
     }
 
-    /* Free storage occupied by this procedure */
-    freeDerivedSeq(*derivedG);
+    /* Free the intervals and derived graphs built for the analysis */
+    derivedNodes.release();
 
 }
+/* Procedures are analysed concurrently only when asked to, and never when the
+ * pass produces ordered output (2nd pass listing, verbose dumps). */
+static bool parallelUdm()
+{
+    return Project::get()->procJobs() > 1 and not (option.asm2 or option.verbose or option.VeryVerbose);
+}
+
+/* Runs action on every procedure of order on the project's threads.  Each task
+ * owns its procedure; with withCallees it also reads and updates the
+ * procedures it calls directly (idioms set the callee's parameter size and
+ * calling convention, HLI_CALLs read them back).  Tasks touching the same
+ * procedure keep their relative order in order, so the outcome is the same
+ * as running them one after the other. */
+static void runPerProc(const std::vector<Function *> &order, bool withCallees,
+                       const std::function<void(Function &)> &action)
+{
+    TaskGraph tasks;
+    std::unordered_map<Function *,int> lastTask; /* Last task touching a proc */
+    std::vector<Function *> touched;
+    for (Function *f : order)
+    {
+        int id = tasks.addTask([f,&action]() { action(*f); });
+        touched.assign(1,f);
+        if (withCallees)
+        {
+            for (ICODE &ic : f->Icode)
+                if (ic.ll()->src().proc.proc)
+                    touched.push_back(ic.ll()->src().proc.proc);
+        }
+        for (Function *t : touched)
+        {
+            auto iter = lastTask.find(t);
+            if (iter == lastTask.end())
+                lastTask[t] = id;
+            else if (iter->second != id)
+            {
+                tasks.addDependency(iter->second,id);
+                iter->second = id;
+            }
+        }
+    }
+    tasks.run(Project::get()->procJobs());
+}
+
 void udm(void)
 {
 
@@ -78,6 +128,8 @@ void udm(void)
      * icodes to high-level ones */
     Project *proj = Project::get();
     Disassembler ds(2);
+    std::vector<Function *> order;
+    PhaseTimer buildTimer(PH_BUILD_CFG);
     for (auto iter = proj->pProcList.rbegin(); iter!=proj->pProcList.rend(); ++iter)
     {
         Function &f(*iter);
@@ -86,8 +138,14 @@ void udm(void)
                 continue;
             }
         }
-        iter->buildCFG(ds);
+        if(parallelUdm())
+            order.push_back(&f);
+        else
+            iter->buildCFG(ds);
     }
+    if(parallelUdm())
+        runPerProc(order, true, [&ds](Function &f) { f.buildCFG(ds); });
+    buildTimer.stop();
     if (option.asm2)
         return;
 
@@ -102,16 +160,30 @@ void udm(void)
             qCritical()<< "No function found at entry point" << QString::number(option.CustomEntryPoint,16);
             return;
         }
+        PhaseTimer dataFlowTimer(PH_DATA_FLOW);
         iter->dataFlow(live_regs);
+        dataFlowTimer.stop();
+        PhaseTimer controlFlowTimer(PH_CONTROL_FLOW);
         iter->controlFlowAnalysis();
+        controlFlowTimer.stop();
         delete proj->callGraph;
-        proj->callGraph = new CALL_GRAPH;
-        proj->callGraph->proc = iter;
+        proj->callGraph = new CALL_GRAPH(iter);
         return;
     }
+    PhaseTimer dataFlowTimer(PH_DATA_FLOW);
     proj->pProcList.front().dataFlow (live_regs);
+    dataFlowTimer.stop();
 
     /* Control flow analysis - structuring algorithm */
+    PhaseTimer controlFlowTimer(PH_CONTROL_FLOW);
+    if(parallelUdm())
+    {
+        order.clear();
+        for (auto iter = proj->pProcList.rbegin(); iter!=proj->pProcList.rend(); ++iter)
+            order.push_back(&(*iter));
+        runPerProc(order, false, [](Function &f) { f.controlFlowAnalysis(); });
+        return;
+    }
     for (auto iter = proj->pProcList.rbegin(); iter!=proj->pProcList.rend(); ++iter)
     {
         iter->controlFlowAnalysis();
@@ -3,6 +3,7 @@
 #include "LIB_PatternCollector.h"
 #include "TPL_PatternCollector.h"
 #include "perfhlib.h"		/* Symbol table prototypes */
+#include "SigFile.h"
 #include "msvc_fixes.h"
 
 #include <QtCore/QCoreApplication>
@@ -14,6 +15,7 @@
 #include <memory.h>
 #include <string.h>
 #include <algorithm>
+#include <vector>
 
 /* Symbol table constnts */
 #define C 2.2 /* Sparseness of graph. See Czech, Havas and Majewski for details */
@@ -21,6 +23,7 @@
 /* prototypes */
 
 void saveFile(FILE *fl, const PerfectHash &p_hash, PatternCollector *coll);		/* Save the info */
+static int convertFile(const char *src, const char *dst, bool isSig);
 
 static int	 numKeys;				/* Number of useful codeview symbols */
 
@@ -33,6 +36,9 @@ static void printUsage(bool longusage) {
                     "of the signature file to be generated.\n"
                     "Example: makedsig CL.LIB dccb3l.sig\n"
                     "      or makedsig turbo.tpl dcct4p.sig\n"
+                    "A signature file (.sig) or prototype file (.dat) written by an earlier "
+                    "version can be given instead of the library, to convert it to the current format.\n"
+                    "Example: makedsig old/dccb3l.sig dccb3l.sig\n"
                     );
     else
         printf("Usage: makedsig <libname> <signame>\n"
@@ -54,6 +60,12 @@ int main(int argc, char *argv[])
         printUsage(true);
         return 0;
     }
+    if(app.arguments().size()<3) {
+        printUsage(false);
+        return 0;
+    }
+    if(arg2.endsWith(".sig") or arg2.endsWith(".dat"))
+        return convertFile(argv[1], argv[2], arg2.endsWith(".sig"));
     PatternCollector *collector;
     if(arg2.endsWith("tpl")) {
         collector = new TPL_PatternCollector;
@@ -109,71 +121,44 @@ int main(int argc, char *argv[])
 \*	*	*	*	*	*	*	*	*	*	*	*  */
 
 
-void writeFile(FILE *fl,const char *buffer, int len)
+void saveFile(FILE *fl, const PerfectHash &p_hash, PatternCollector *coll)
 {
-    if ((int)fwrite(buffer, 1, len, fl) != len)
+    std::vector<SigFileEntry> ht(numKeys);
+    for (int i=0; i < numKeys; i++)
+    {
+        memcpy(ht[i].sym, coll->keys[i].name, SYMLEN);
+        memcpy(ht[i].pat, coll->keys[i].pat, PATLEN);
+    }
+    if (not writeSigFile(fl, p_hash, numKeys, (int)(numKeys * C), ht.data()))
     {
         printf("Could not write to file\n");
         exit(1);
     }
 }
 
-void writeFileShort(FILE *fl,uint16_t w)
-{
-    uint8_t b;
-
-    b = (uint8_t)(w & 0xFF);
-    writeFile(fl,(char *)&b, 1);		/* Write a short little endian */
-    b = (uint8_t)(w>>8);
-    writeFile(fl,(char *)&b, 1);
-}
-
-void saveFile(FILE *fl, const PerfectHash &p_hash, PatternCollector *coll)
+/* Rewrites a signature or prototype file of an earlier version in the
+    current format */
+static int convertFile(const char *src, const char *dst, bool isSig)
 {
-    int i, len;
-    const uint16_t *pTable;
-
-    writeFile(fl,"dccs", 4);					/* Signature */
-    writeFileShort(fl,numKeys);				/* Number of keys */
-    writeFileShort(fl,(short)(numKeys * C));	/* Number of vertices */
-    writeFileShort(fl,PATLEN);					/* Length of key part of entries */
-    writeFileShort(fl,SYMLEN);					/* Length of symbol part of entries */
-
-    /* Write out the tables T1 and T2, with their sig and byte lengths in front */
-    writeFile(fl,"T1", 2);						/* "Signature" */
-    pTable = p_hash.readT1();
-    len = PATLEN * 256;
-    writeFileShort(fl,len * sizeof(uint16_t));
-    for (i=0; i < len; i++)
+    SigFile sigs;
+    ProtoFile protos;
+    if (isSig ? not sigs.load(src) : not protos.load(src))
+        return 2;
+    FILE *f = fopen(dst, "wb");
+    if (f == NULL)
     {
-        writeFileShort(fl,pTable[i]);
+        printf("Cannot write %s\n", dst);
+        return 2;
     }
-    writeFile(fl,"T2", 2);
-    pTable = p_hash.readT2();
-    writeFileShort(fl,len * sizeof(uint16_t));
-    for (i=0; i < len; i++)
-    {
-        writeFileShort(fl,pTable[i]);
-    }
-
-    /* Write out g[] */
-    writeFile(fl,"gg", 2);			  			/* "Signature" */
-    pTable = p_hash.readG();
-    len = (short)(numKeys * C);
-    writeFileShort(fl,len * sizeof(uint16_t));
-    for (i=0; i < len; i++)
-    {
-        writeFileShort(fl,pTable[i]);
-    }
-
-    /* Now the hash table itself */
-    writeFile(fl,"ht ", 2);			  			/* "Signature" */
-    writeFileShort(fl,numKeys * (SYMLEN + PATLEN + sizeof(uint16_t)));	/* byte len */
-    for (i=0; i < numKeys; i++)
+    bool ok;
+    if (isSig)
+        ok = writeSigFile(f, sigs.hasher, sigs.numKeys, sigs.numVert, sigs.ht);
+    else
+        ok = writeProtoFile(f, protos.func, protos.numFunc, protos.arg, protos.numArg);
+    if (fclose(f) != 0 or not ok)
     {
-        writeFile(fl,(char *)&coll->keys[i], SYMLEN + PATLEN);
+        printf("Could not write to file\n");
+        return 1;
     }
+    return 0;
 }
-
-
-
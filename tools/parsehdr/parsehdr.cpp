@@ -5,10 +5,12 @@
 /* Descended from xansi; thanks Geoff! thanks Glenn! */
 
 #include "parsehdr.h"
+#include "SigFile.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <algorithm>
+#include <vector>
 
 static dword userval;
 namespace {
@@ -1108,41 +1110,28 @@ void phBuffToFunc(char *buff) {
 
 void phBuffToDef(char *buff) {}
 
-void writeFile(char *buffer, int len) {
-  if ((int)fwrite(buffer, 1, len, datFile) != len) {
-    printf("Could not write to file\n");
-    exit(1);
-  }
-}
-
-void writeFileShort(word w) {
-  byte b;
-
-  b = (byte)(w & 0xFF);
-  writeFile((char *)&b, 1); /* Write a short little endian */
-  b = (byte)(w >> 8);
-  writeFile((char *)&b, 1);
-}
-
 void saveFile(void) {
+  std::vector<ProtoFileFunc> funcs;
+  std::vector<uint16_t> args(numArg);
   int i;
 
-  fprintf(datFile, "dccp"); /* Signature */
-  fprintf(datFile, "FN");   /* Function name tag */
-  writeFileShort(numFunc);  /* Number of func name records */
+  /* The functions in name order, as dcc binary searches them */
   for (i = headFunc; i != NIL; i = pFunc[i].next) {
-    writeFile(pFunc[i].name, SYMLEN);
-    writeFileShort((word)pFunc[i].typ);
-    writeFileShort((word)pFunc[i].numArg);
-    writeFileShort((word)pFunc[i].firstArg);
-    writeFile((char *)&pFunc[i].bVararg, 1);
+    ProtoFileFunc f;
+    memset(&f, 0, sizeof(f));
+    memcpy(f.name, pFunc[i].name, SYMLEN);
+    f.typ = (uint16_t)pFunc[i].typ;
+    f.numArg = (uint16_t)pFunc[i].numArg;
+    f.firstArg = (uint16_t)pFunc[i].firstArg;
+    f.bVararg = pFunc[i].bVararg;
+    funcs.push_back(f);
   }
+  for (i = 0; i < numArg; i++)
+    args[i] = (uint16_t)pArg[i].typ;
 
-  fprintf(datFile, "PM"); /* Parameter Name tag */
-  writeFileShort(numArg); /* Number of args */
-  for (i = 0; i < numArg; i++) {
-    //      writeFile(pArg[i].name, SYMLEN);    // Don't want names yet
-    writeFileShort((word)pArg[i].typ);
+  if (!writeProtoFile(datFile, funcs.data(), funcs.size(), args.data(), numArg)) {
+    printf("Could not write to file\n");
+    exit(1);
   }
 }
 